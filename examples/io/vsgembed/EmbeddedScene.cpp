@@ -0,0 +1,231 @@
+#include "EmbeddedScene.h"
+
+#include <algorithm>
+#include <cstring>
+#include <functional>
+#include <set>
+#include <sstream>
+
+// register EmbeddedStorage so vsg::Input can create it when reading the scene blob.
+static vsg::RegisterWithObjectFactoryProxy<EmbeddedStorage> s_Register_EmbeddedStorage;
+
+// user object key used to pass the payload via vsg::Options to EmbeddedStorage::read()
+static const char* const embeddedPayloadKey = "EmbeddedPayload";
+
+void EmbeddedStorage::read(vsg::Input& input)
+{
+    vsg::Object::read(input);
+
+    auto payloadSize = input.readValue<uint32_t>("size");
+
+    auto payload = input.options ? input.options->getObject<vsg::ubyteArray>(embeddedPayloadKey) : nullptr;
+    if (!payload || payload->size() < payloadSize)
+    {
+        vsg::warn("EmbeddedStorage::read() no payload of size ", payloadSize, " assigned to Options.");
+        return;
+    }
+
+    // wrap the payload memory, it's owned by the executable so must never be deleted.
+    vsg::Data::Properties payloadProperties;
+    payloadProperties.allocatorType = vsg::ALLOCATOR_TYPE_NO_DELETE;
+    assign(payloadSize, const_cast<uint8_t*>(payload->data()), payloadProperties);
+}
+
+void EmbeddedStorage::write(vsg::Output& output) const
+{
+    vsg::Object::write(output);
+
+    output.writeValue<uint32_t>("size", size());
+}
+
+namespace
+{
+    // collect the arrays in a scene graph that are large and contiguous enough to move into the payload.
+    class CollectArrays : public vsg::Visitor
+    {
+    public:
+        struct Entry
+        {
+            vsg::ref_ptr<vsg::Data> data;
+            std::function<void(vsg::ref_ptr<vsg::Data> storage, uint32_t offset)> assign;
+        };
+
+        std::vector<Entry> entries;
+        std::set<const vsg::Object*> visited;
+
+        using vsg::Visitor::apply;
+
+        void apply(vsg::Object& object) override
+        {
+            if (visited.insert(&object).second) object.traverse(*this);
+        }
+
+        void apply(vsg::StateGroup& stateGroup) override
+        {
+            if (!visited.insert(&stateGroup).second) return;
+
+            for (auto& sc : stateGroup.stateCommands)
+            {
+                sc->accept(*this);
+            }
+
+            stateGroup.traverse(*this);
+        }
+
+        // arrays types commonly found in vertex, index and image data
+        void apply(vsg::ubyteArray& array) override { collect(array); }
+        void apply(vsg::ushortArray& array) override { collect(array); }
+        void apply(vsg::uintArray& array) override { collect(array); }
+        void apply(vsg::floatArray& array) override { collect(array); }
+        void apply(vsg::vec2Array& array) override { collect(array); }
+        void apply(vsg::vec3Array& array) override { collect(array); }
+        void apply(vsg::vec4Array& array) override { collect(array); }
+        void apply(vsg::ubvec4Array& array) override { collect(array); }
+        void apply(vsg::ubyteArray2D& array) override { collect(array); }
+        void apply(vsg::floatArray2D& array) override { collect(array); }
+        void apply(vsg::vec4Array2D& array) override { collect(array); }
+        void apply(vsg::ubvec4Array2D& array) override { collect(array); }
+        void apply(vsg::block64Array2D& array) override { collect(array); }
+        void apply(vsg::block128Array2D& array) override { collect(array); }
+        void apply(vsg::ubyteArray3D& array) override { collect(array); }
+        void apply(vsg::floatArray3D& array) override { collect(array); }
+
+    protected:
+        bool suitable(vsg::Data& data)
+        {
+            if (!visited.insert(&data).second) return false;
+            return data.properties.stride == data.valueSize() && data.dataSize() >= embeddedMinimumArraySize;
+        }
+
+        template<typename T>
+        void collect(vsg::Array<T>& array)
+        {
+            if (!suitable(array)) return;
+
+            auto properties = array.properties;
+            auto width = array.width();
+            entries.push_back(Entry{vsg::ref_ptr<vsg::Data>(&array), [&array, properties, width](vsg::ref_ptr<vsg::Data> storage, uint32_t offset) {
+                                        array.assign(storage, offset, properties.stride, width, properties);
+                                    }});
+        }
+
+        template<typename T>
+        void collect(vsg::Array2D<T>& array)
+        {
+            if (!suitable(array)) return;
+
+            auto properties = array.properties;
+            auto width = array.width();
+            auto height = array.height();
+            entries.push_back(Entry{vsg::ref_ptr<vsg::Data>(&array), [&array, properties, width, height](vsg::ref_ptr<vsg::Data> storage, uint32_t offset) {
+                                        array.assign(storage, offset, properties.stride, width, height, properties);
+                                    }});
+        }
+
+        template<typename T>
+        void collect(vsg::Array3D<T>& array)
+        {
+            if (!suitable(array)) return;
+
+            auto properties = array.properties;
+            auto width = array.width();
+            auto height = array.height();
+            auto depth = array.depth();
+            entries.push_back(Entry{vsg::ref_ptr<vsg::Data>(&array), [&array, properties, width, height, depth](vsg::ref_ptr<vsg::Data> storage, uint32_t offset) {
+                                        array.assign(storage, offset, properties.stride, width, height, depth, properties);
+                                    }});
+        }
+    };
+
+    size_t alignPayloadOffset(size_t offset)
+    {
+        return ((offset + embeddedPayloadAlignment - 1) / embeddedPayloadAlignment) * embeddedPayloadAlignment;
+    }
+
+    void writeBytes(std::ostream& out, const uint8_t* ptr, size_t size)
+    {
+        const size_t bytesPerLine = 32;
+        for (size_t i = 0; i < size; ++i)
+        {
+            if ((i % bytesPerLine) == 0) out << "\n    ";
+            out << static_cast<uint32_t>(ptr[i]) << ",";
+        }
+        out << "\n";
+    }
+} // namespace
+
+EmbeddedScene createEmbeddedScene(vsg::ref_ptr<vsg::Object> object, vsg::ref_ptr<const vsg::Options> options)
+{
+    EmbeddedScene embeddedScene;
+    if (!object) return embeddedScene;
+
+    CollectArrays collectArrays;
+    object->accept(collectArrays);
+
+    // compute the aligned position of each array within the payload
+    std::vector<size_t> offsets;
+    size_t payloadSize = 0;
+    for (auto& entry : collectArrays.entries)
+    {
+        payloadSize = alignPayloadOffset(payloadSize);
+        offsets.push_back(payloadSize);
+        payloadSize += entry.data->dataSize();
+    }
+
+    // C++ doesn't permit zero sized arrays so always provide at least one byte of payload.
+    embeddedScene.payload = EmbeddedStorage::create(static_cast<uint32_t>(std::max(payloadSize, size_t(1))));
+    std::memset(embeddedScene.payload->data(), 0, embeddedScene.payload->dataSize());
+
+    // copy each array into the payload and then reassign it to be a view into the payload
+    for (size_t i = 0; i < collectArrays.entries.size(); ++i)
+    {
+        auto& entry = collectArrays.entries[i];
+        std::memcpy(embeddedScene.payload->data() + offsets[i], entry.data->dataPointer(), entry.data->dataSize());
+        entry.assign(embeddedScene.payload, static_cast<uint32_t>(offsets[i]));
+    }
+    embeddedScene.numArrays = collectArrays.entries.size();
+
+    auto binaryOptions = options ? vsg::Options::create(*options) : vsg::Options::create();
+    binaryOptions->extensionHint = ".vsgb";
+
+    std::ostringstream sstr;
+    vsg::VSG io;
+    io.write(object, sstr, binaryOptions);
+    embeddedScene.scene = sstr.str();
+
+    return embeddedScene;
+}
+
+void writeEmbeddedSource(std::ostream& out, const std::string& name, const EmbeddedScene& embeddedScene, const vsg::Path& source)
+{
+    out << "// generated by vsgembed from " << source << ", do not edit.\n";
+    out << "#include \"EmbeddedScene.h\"\n\n";
+
+    out << "static const uint8_t " << name << "_scene[] = {";
+    writeBytes(out, reinterpret_cast<const uint8_t*>(embeddedScene.scene.data()), embeddedScene.scene.size());
+    out << "};\n\n";
+
+    // payload is deliberately non const as arrays in the loaded scene graph are views directly into it.
+    out << "alignas(" << embeddedPayloadAlignment << ") static uint8_t " << name << "_payload[] = {";
+    writeBytes(out, embeddedScene.payload->data(), embeddedScene.payload->dataSize());
+    out << "};\n\n";
+
+    out << "vsg::ref_ptr<vsg::Object> " << name << "(vsg::ref_ptr<const vsg::Options> options)\n";
+    out << "{\n";
+    out << "    return readEmbeddedScene(" << name << "_scene, sizeof(" << name << "_scene), " << name << "_payload, sizeof(" << name << "_payload), options);\n";
+    out << "}\n";
+}
+
+vsg::ref_ptr<vsg::Object> readEmbeddedScene(const uint8_t* scene, size_t sceneSize, uint8_t* payload, size_t payloadSize, vsg::ref_ptr<const vsg::Options> options)
+{
+    // wrap the payload without copying it so EmbeddedStorage::read() can pick it up
+    vsg::Data::Properties payloadProperties;
+    payloadProperties.allocatorType = vsg::ALLOCATOR_TYPE_NO_DELETE;
+    auto payloadArray = vsg::ubyteArray::create(static_cast<uint32_t>(payloadSize), payload, payloadProperties);
+
+    auto local_options = options ? vsg::Options::create(*options) : vsg::Options::create();
+    local_options->setObject(embeddedPayloadKey, payloadArray);
+
+    vsg::VSG io;
+    return io.read(scene, sceneSize, local_options);
+}
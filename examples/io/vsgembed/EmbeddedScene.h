@@ -0,0 +1,42 @@
+#pragma once
+
+#include <vsg/all.h>
+
+#include <ostream>
+
+// EmbeddedStorage is the single block of raw array data that an embedded scene's arrays are views into.
+// When written it only records its size, when read it wraps the payload that the application has compiled
+// into its executable so no array data is copied or parsed at startup.
+class EmbeddedStorage : public vsg::Inherit<vsg::ubyteArray, EmbeddedStorage>
+{
+public:
+    EmbeddedStorage() {}
+    explicit EmbeddedStorage(uint32_t size) :
+        Inherit(size) {}
+
+    void read(vsg::Input& input) override;
+    void write(vsg::Output& output) const override;
+};
+EVSG_type_name(EmbeddedStorage);
+
+// data alignment, in bytes, of each array within the payload.
+constexpr size_t embeddedPayloadAlignment = 16;
+
+// only arrays of at least this many bytes are moved into the payload, smaller arrays stay in the scene blob.
+constexpr size_t embeddedMinimumArraySize = 64;
+
+struct EmbeddedScene
+{
+    std::string scene;                     // binary .vsgb stream of the scene graph, with large arrays referencing payload
+    vsg::ref_ptr<EmbeddedStorage> payload; // aligned raw array data
+    size_t numArrays = 0;                  // number of arrays moved into the payload
+};
+
+// convert object into an embeddable scene, large arrays in object are reassigned to be views into the returned payload.
+extern EmbeddedScene createEmbeddedScene(vsg::ref_ptr<vsg::Object> object, vsg::ref_ptr<const vsg::Options> options = {});
+
+// write EmbeddedScene as C++ source providing the function: vsg::ref_ptr<vsg::Object> name(vsg::ref_ptr<const vsg::Options> options = {});
+extern void writeEmbeddedSource(std::ostream& out, const std::string& name, const EmbeddedScene& embeddedScene, const vsg::Path& source);
+
+// read an embedded scene, arrays in the returned scene graph reference payload directly rather than copies of it.
+extern vsg::ref_ptr<vsg::Object> readEmbeddedScene(const uint8_t* scene, size_t sceneSize, uint8_t* payload, size_t payloadSize, vsg::ref_ptr<const vsg::Options> options = {});
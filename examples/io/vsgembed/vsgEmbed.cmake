@@ -0,0 +1,38 @@
+# Build time conversion of scene files into C++ sources that are compiled into an application,
+# the embedded scene loads with its arrays as views directly into the executable's data segment.
+#
+# Usage :
+#     include(path/to/vsgEmbed.cmake)
+#     embed_vsg_scene(<target> <name> <input_scene>)
+#
+# which adds a generated <name>.cpp to <target> providing the function:
+#     vsg::ref_ptr<vsg::Object> <name>(vsg::ref_ptr<const vsg::Options> options);
+#
+# When cross compiling, i.e. for iOS or Android builds, set VSGEMBED_EXECUTABLE to a host build of vsgembed,
+# otherwise the vsgembed target from this project is used.
+
+set(VSGEMBED_SOURCE_DIR ${CMAKE_CURRENT_LIST_DIR})
+
+function(embed_vsg_scene TARGET NAME INPUT)
+
+    if (VSGEMBED_EXECUTABLE)
+        set(EMBED_COMMAND ${VSGEMBED_EXECUTABLE})
+        set(EMBED_DEPENDS ${INPUT})
+    else()
+        set(EMBED_COMMAND $<TARGET_FILE:vsgembed>)
+        set(EMBED_DEPENDS ${INPUT} vsgembed)
+    endif()
+
+    set(OUTPUT ${CMAKE_CURRENT_BINARY_DIR}/${NAME}.cpp)
+
+    add_custom_command(
+        OUTPUT ${OUTPUT}
+        COMMAND ${EMBED_COMMAND} ${INPUT} -o ${OUTPUT} --name ${NAME}
+        DEPENDS ${EMBED_DEPENDS}
+        COMMENT "Embedding ${INPUT} as ${NAME}()"
+    )
+
+    target_sources(${TARGET} PRIVATE ${OUTPUT} ${VSGEMBED_SOURCE_DIR}/EmbeddedScene.cpp)
+    target_include_directories(${TARGET} PRIVATE ${VSGEMBED_SOURCE_DIR})
+
+endfunction()
@@ -0,0 +1,69 @@
+#include <vsg/all.h>
+
+#ifdef vsgXchange_FOUND
+#    include <vsgXchange/all.h>
+#endif
+
+#include <cctype>
+#include <fstream>
+#include <iostream>
+
+#include "EmbeddedScene.h"
+
+int main(int argc, char** argv)
+{
+    vsg::CommandLine arguments(&argc, argv);
+
+    auto options = vsg::Options::create();
+    options->paths = vsg::getEnvPaths("VSG_FILE_PATH");
+
+#ifdef vsgXchange_all
+    // add vsgXchange's support for reading and writing 3rd party file formats
+    options->add(vsgXchange::all::create());
+#endif
+
+    arguments.read(options);
+
+    auto outputFilename = arguments.value(vsg::Path(), "-o");
+    auto name = arguments.value(std::string(), "--name");
+
+    if (arguments.errors()) return arguments.writeErrorMessages(std::cerr);
+
+    if (argc != 2 || !outputFilename)
+    {
+        std::cout << "Usage: vsgembed input_scene -o output.cpp [--name function_name]" << std::endl;
+        return 1;
+    }
+
+    vsg::Path inputFilename = arguments[1];
+    auto object = vsg::read(inputFilename, options);
+    if (!object)
+    {
+        std::cout << "Warning: unable to read file : " << inputFilename << std::endl;
+        return 1;
+    }
+
+    // default to naming the embedded function after the output file, then make sure it's a valid C++ identifier.
+    if (name.empty()) name = vsg::simpleFilename(outputFilename).string();
+    for (auto& c : name)
+    {
+        if (!std::isalnum(static_cast<unsigned char>(c))) c = '_';
+    }
+    if (name.empty() || std::isdigit(static_cast<unsigned char>(name[0]))) name.insert(0, "scene_");
+
+    auto embeddedScene = createEmbeddedScene(object, options);
+
+    std::ofstream fout(outputFilename.string());
+    if (!fout)
+    {
+        std::cout << "Warning: unable to write file : " << outputFilename << std::endl;
+        return 1;
+    }
+
+    writeEmbeddedSource(fout, name, embeddedScene, vsg::simpleFilename(inputFilename) + vsg::fileExtension(inputFilename));
+
+    std::cout << "vsgembed " << inputFilename << " -> " << outputFilename << " as " << name << "(), scene = " << embeddedScene.scene.size()
+              << " bytes, payload = " << embeddedScene.payload->dataSize() << " bytes in " << embeddedScene.numArrays << " arrays." << std::endl;
+
+    return 0;
+}
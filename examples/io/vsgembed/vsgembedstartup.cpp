@@ -0,0 +1,87 @@
+#include <vsg/all.h>
+
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <sstream>
+
+// provided by the lz.cpp that embed_vsg_scene() generates at build time from data/models/lz.vsgt
+extern vsg::ref_ptr<vsg::Object> lz(vsg::ref_ptr<const vsg::Options> options);
+
+int main(int argc, char** argv)
+{
+    vsg::CommandLine arguments(&argc, argv);
+
+    auto options = vsg::Options::create();
+    options->paths = vsg::getEnvPaths("VSG_FILE_PATH");
+
+    auto numRepeats = arguments.value(10u, "-n");
+    auto inputFilename = arguments.value(vsg::Path("models/lz.vsgt"), "-i");
+
+    if (arguments.errors()) return arguments.writeErrorMessages(std::cerr);
+
+    auto filename = vsg::findFile(inputFilename, options);
+    std::ifstream fin(filename.string(), std::ios::in | std::ios::binary);
+    if (!fin)
+    {
+        std::cout << "Warning: could not find file : " << inputFilename << ", please set VSG_FILE_PATH to the vsgExamples/data directory." << std::endl;
+        return 1;
+    }
+
+    // the existing mobile examples compile the .vsgt text into the executable, so load all forms from memory for a like for like comparison.
+    std::string ascii((std::istreambuf_iterator<char>(fin)), std::istreambuf_iterator<char>());
+
+    vsg::VSG io;
+    auto object = io.read(reinterpret_cast<const uint8_t*>(ascii.data()), ascii.size(), options);
+    if (!object)
+    {
+        std::cout << "Warning: unable to parse file : " << filename << std::endl;
+        return 1;
+    }
+
+    auto binaryOptions = vsg::Options::create(*options);
+    binaryOptions->extensionHint = ".vsgb";
+
+    std::ostringstream binary_stream;
+    io.write(object, binary_stream, binaryOptions);
+    std::string binary = binary_stream.str();
+
+    auto timeLoads = [&](const char* description, auto load) {
+        double totalTime = 0.0;
+        double minTime = std::numeric_limits<double>::max();
+        for (uint32_t i = 0; i < numRepeats; ++i)
+        {
+            auto start = vsg::clock::now();
+            auto loaded = load();
+            auto time = std::chrono::duration<double, std::chrono::milliseconds::period>(vsg::clock::now() - start).count();
+            if (!loaded) std::cout << "Warning: " << description << " load failed." << std::endl;
+
+            totalTime += time;
+            minTime = std::min(minTime, time);
+        }
+
+        double averageTime = totalTime / static_cast<double>(numRepeats);
+        std::cout << description << " average load = " << averageTime << "ms, min load = " << minTime << "ms" << std::endl;
+        return averageTime;
+    };
+
+    std::cout << "Startup load of " << filename << ", " << numRepeats << " repeats." << std::endl;
+    std::cout << "ascii size = " << ascii.size() << " bytes, binary size = " << binary.size() << " bytes" << std::endl;
+
+    auto asciiTime = timeLoads("ascii .vsgt  ", [&]() {
+        return io.read(reinterpret_cast<const uint8_t*>(ascii.data()), ascii.size(), options);
+    });
+
+    auto binaryTime = timeLoads("binary .vsgb ", [&]() {
+        return io.read(reinterpret_cast<const uint8_t*>(binary.data()), binary.size(), options);
+    });
+
+    auto embeddedTime = timeLoads("embedded lz()", [&]() {
+        return lz(options);
+    });
+
+    std::cout << "binary speed up over ascii   = " << asciiTime / binaryTime << std::endl;
+    std::cout << "embedded speed up over ascii = " << asciiTime / embeddedTime << std::endl;
+
+    return 0;
+}
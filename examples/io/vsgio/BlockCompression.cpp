@@ -0,0 +1,269 @@
+#include "BlockCompression.h"
+
+#include <cstring>
+
+namespace
+{
+    const size_t minMatch = 4;
+    const size_t lastLiterals = 5; // bytes at the end of each block always encoded as literals
+    const size_t maxOffset = 65535;
+    const uint32_t hashBits = 14;
+
+    inline uint32_t read32(const uint8_t* ptr)
+    {
+        uint32_t value;
+        std::memcpy(&value, ptr, sizeof(value));
+        return value;
+    }
+
+    inline uint32_t hash(uint32_t sequence)
+    {
+        return (sequence * 2654435761u) >> (32 - hashBits);
+    }
+
+    inline void writeLength(size_t length, std::vector<uint8_t>& dst)
+    {
+        for (; length >= 255; length -= 255) dst.push_back(255);
+        dst.push_back(static_cast<uint8_t>(length));
+    }
+
+    inline bool readLength(const uint8_t* src, size_t compressedSize, size_t& ip, size_t& length)
+    {
+        uint8_t b = 255;
+        while (b == 255)
+        {
+            if (ip >= compressedSize) return false;
+            b = src[ip++];
+            length += b;
+        }
+        return true;
+    }
+
+    void writeSequence(const uint8_t* literals, size_t numLiterals, size_t offset, size_t matchLength, std::vector<uint8_t>& dst)
+    {
+        size_t matchCode = matchLength >= minMatch ? matchLength - minMatch : 0;
+
+        uint8_t token = static_cast<uint8_t>(((numLiterals < 15 ? numLiterals : 15) << 4) | (matchCode < 15 ? matchCode : 15));
+        dst.push_back(token);
+        if (numLiterals >= 15) writeLength(numLiterals - 15, dst);
+
+        dst.insert(dst.end(), literals, literals + numLiterals);
+
+        // the last sequence in a block has literals only
+        if (matchLength == 0) return;
+
+        dst.push_back(static_cast<uint8_t>(offset & 0xff));
+        dst.push_back(static_cast<uint8_t>(offset >> 8));
+        if (matchCode >= 15) writeLength(matchCode - 15, dst);
+    }
+
+    template<typename T>
+    void deltaEncode(uint8_t* data, size_t size, size_t distance)
+    {
+        size_t count = size / sizeof(T);
+        for (size_t i = count; i-- > distance;)
+        {
+            T current, previous;
+            std::memcpy(&current, data + i * sizeof(T), sizeof(T));
+            std::memcpy(&previous, data + (i - distance) * sizeof(T), sizeof(T));
+            current = static_cast<T>(current - previous);
+            std::memcpy(data + i * sizeof(T), &current, sizeof(T));
+        }
+    }
+
+    template<typename T>
+    void deltaDecode(uint8_t* data, size_t size, size_t distance)
+    {
+        size_t count = size / sizeof(T);
+        for (size_t i = distance; i < count; ++i)
+        {
+            T current, previous;
+            std::memcpy(&current, data + i * sizeof(T), sizeof(T));
+            std::memcpy(&previous, data + (i - distance) * sizeof(T), sizeof(T));
+            current = static_cast<T>(current + previous);
+            std::memcpy(data + i * sizeof(T), &current, sizeof(T));
+        }
+    }
+
+    void applyDelta(uint8_t* data, size_t size, const BlockLayout& layout, bool encode)
+    {
+        size_t distance = layout.valueSize / layout.componentSize;
+        if (distance == 0) return;
+
+        switch (layout.componentSize)
+        {
+        case 1: encode ? deltaEncode<uint8_t>(data, size, distance) : deltaDecode<uint8_t>(data, size, distance); break;
+        case 2: encode ? deltaEncode<uint16_t>(data, size, distance) : deltaDecode<uint16_t>(data, size, distance); break;
+        case 4: encode ? deltaEncode<uint32_t>(data, size, distance) : deltaDecode<uint32_t>(data, size, distance); break;
+        case 8: encode ? deltaEncode<uint64_t>(data, size, distance) : deltaDecode<uint64_t>(data, size, distance); break;
+        default: break;
+        }
+    }
+
+    void shuffle(const uint8_t* src, uint8_t* dst, size_t size, size_t componentSize)
+    {
+        size_t count = size / componentSize;
+        for (size_t i = 0; i < count; ++i)
+        {
+            for (size_t b = 0; b < componentSize; ++b)
+            {
+                dst[b * count + i] = src[i * componentSize + b];
+            }
+        }
+        std::memcpy(dst + count * componentSize, src + count * componentSize, size - count * componentSize);
+    }
+
+    void unshuffle(const uint8_t* src, uint8_t* dst, size_t size, size_t componentSize)
+    {
+        size_t count = size / componentSize;
+        for (size_t i = 0; i < count; ++i)
+        {
+            for (size_t b = 0; b < componentSize; ++b)
+            {
+                dst[i * componentSize + b] = src[b * count + i];
+            }
+        }
+        std::memcpy(dst + count * componentSize, src + count * componentSize, size - count * componentSize);
+    }
+} // namespace
+
+void compressLZ(const uint8_t* src, size_t size, std::vector<uint8_t>& dst)
+{
+    size_t anchor = 0;
+
+    if (size > minMatch + lastLiterals)
+    {
+        std::vector<uint32_t> table(size_t(1) << hashBits, 0);
+
+        size_t matchLimit = size - lastLiterals;
+        size_t ip = 0;
+        while (ip + minMatch <= matchLimit)
+        {
+            uint32_t sequence = read32(src + ip);
+            uint32_t h = hash(sequence);
+            size_t ref = table[h];
+            table[h] = static_cast<uint32_t>(ip);
+
+            if (ref < ip && (ip - ref) <= maxOffset && read32(src + ref) == sequence)
+            {
+                size_t matchLength = minMatch;
+                while (ip + matchLength < matchLimit && src[ref + matchLength] == src[ip + matchLength]) ++matchLength;
+
+                writeSequence(src + anchor, ip - anchor, ip - ref, matchLength, dst);
+
+                ip += matchLength;
+                anchor = ip;
+            }
+            else
+            {
+                // skip ahead faster through data that isn't matching
+                ip += 1 + ((ip - anchor) >> 6);
+            }
+        }
+    }
+
+    writeSequence(src + anchor, size - anchor, 0, 0, dst);
+}
+
+bool decompressLZ(const uint8_t* src, size_t compressedSize, uint8_t* dst, size_t size)
+{
+    size_t ip = 0;
+    size_t op = 0;
+    while (ip < compressedSize)
+    {
+        uint8_t token = src[ip++];
+
+        size_t numLiterals = token >> 4;
+        if (numLiterals == 15 && !readLength(src, compressedSize, ip, numLiterals)) return false;
+        if (ip + numLiterals > compressedSize || op + numLiterals > size) return false;
+
+        std::memcpy(dst + op, src + ip, numLiterals);
+        ip += numLiterals;
+        op += numLiterals;
+
+        // last sequence
+        if (ip == compressedSize) break;
+
+        if (ip + 2 > compressedSize) return false;
+        size_t offset = src[ip] | (size_t(src[ip + 1]) << 8);
+        ip += 2;
+        if (offset == 0 || offset > op) return false;
+
+        size_t matchLength = token & 15;
+        if (matchLength == 15 && !readLength(src, compressedSize, ip, matchLength)) return false;
+        matchLength += minMatch;
+        if (op + matchLength > size) return false;
+
+        uint8_t* match = dst + op - offset;
+        if (offset >= matchLength)
+        {
+            std::memcpy(dst + op, match, matchLength);
+        }
+        else
+        {
+            // overlapping copy repeats the last offset bytes
+            for (size_t i = 0; i < matchLength; ++i) dst[op + i] = match[i];
+        }
+        op += matchLength;
+    }
+
+    return op == size;
+}
+
+size_t compressBlock(const uint8_t* src, size_t size, const BlockLayout& layout, std::vector<uint8_t>& dst)
+{
+    if (size == 0) return 0;
+
+    size_t start = dst.size();
+
+    const uint8_t* source = src;
+    std::vector<uint8_t> filtered;
+    if (layout.filters != FILTER_NONE && layout.componentSize > 0)
+    {
+        filtered.assign(src, src + size);
+        if (layout.filters & FILTER_DELTA) applyDelta(filtered.data(), size, layout, true);
+        if ((layout.filters & FILTER_SHUFFLE) && layout.componentSize > 1)
+        {
+            std::vector<uint8_t> shuffled(size);
+            shuffle(filtered.data(), shuffled.data(), size, layout.componentSize);
+            filtered.swap(shuffled);
+        }
+        source = filtered.data();
+    }
+
+    compressLZ(source, size, dst);
+
+    // fallback to storing the original data raw if compression didn't help
+    if (dst.size() - start >= size)
+    {
+        dst.resize(start);
+        dst.insert(dst.end(), src, src + size);
+    }
+
+    return dst.size() - start;
+}
+
+bool decompressBlock(const uint8_t* src, size_t compressedSize, uint8_t* dst, size_t size, const BlockLayout& layout)
+{
+    if (size == 0) return compressedSize == 0;
+
+    if (compressedSize == size)
+    {
+        std::memcpy(dst, src, size);
+        return true;
+    }
+
+    if (!decompressLZ(src, compressedSize, dst, size)) return false;
+
+    if (layout.filters != FILTER_NONE && layout.componentSize > 0)
+    {
+        if ((layout.filters & FILTER_SHUFFLE) && layout.componentSize > 1)
+        {
+            std::vector<uint8_t> shuffled(dst, dst + size);
+            unshuffle(shuffled.data(), dst, size, layout.componentSize);
+        }
+        if (layout.filters & FILTER_DELTA) applyDelta(dst, size, layout, false);
+    }
+
+    return true;
+}
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Fast LZ77 block codec, using an LZ4 style sequence format, with optional filters that make float data more compressible.
+// Each block is filtered and compressed independently so blocks can be encoded and decoded in parallel.
+
+enum CompressionFilters : uint32_t
+{
+    FILTER_NONE = 0,
+    FILTER_DELTA = 1,  // subtract the matching component of the previous value, i.e. x[i] - x[i-1] for a vec3Array
+    FILTER_SHUFFLE = 2 // group bytes of each component together so that exponent and high mantissa bytes sit side by side
+};
+
+struct BlockLayout
+{
+    uint32_t filters = FILTER_NONE;
+    uint32_t componentSize = 1; // size of each float/int component in bytes, used by filters
+    uint32_t valueSize = 1;     // size of each array value in bytes, i.e. 12 for vec3
+};
+
+// append the compressed form of src to dst, returns the number of bytes appended.
+// If the block doesn't compress it's stored raw, in which case the number of bytes appended equals size.
+extern size_t compressBlock(const uint8_t* src, size_t size, const BlockLayout& layout, std::vector<uint8_t>& dst);
+
+// decompress a block of compressedSize bytes into dst of size bytes, returns false if the compressed data is invalid.
+extern bool decompressBlock(const uint8_t* src, size_t compressedSize, uint8_t* dst, size_t size, const BlockLayout& layout);
+
+// raw LZ codec without filters
+extern void compressLZ(const uint8_t* src, size_t size, std::vector<uint8_t>& dst);
+extern bool decompressLZ(const uint8_t* src, size_t compressedSize, uint8_t* dst, size_t size);
@@ -0,0 +1,348 @@
+#include "CompressedStorage.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <functional>
+#include <set>
+#include <thread>
+#include <type_traits>
+
+// register CompressedStorage so vsg::Input can create it when reading files containing compressed arrays.
+static vsg::RegisterWithObjectFactoryProxy<CompressedStorage> s_Register_CompressedStorage;
+
+// user object key used to pass the DecompressQueue via vsg::Options to CompressedStorage::read()
+static const char* const decompressQueueKey = "DecompressQueue";
+
+namespace
+{
+    void runParallel(size_t numJobs, uint32_t numThreads, const std::function<void(size_t)>& job)
+    {
+        std::atomic<size_t> nextJob{0};
+        auto worker = [&]() {
+            for (size_t i = nextJob++; i < numJobs; i = nextJob++) job(i);
+        };
+
+        std::vector<std::thread> threads;
+        for (uint32_t t = 1; t < numThreads && t < numJobs; ++t) threads.emplace_back(worker);
+
+        worker();
+
+        for (auto& thread : threads) thread.join();
+    }
+
+    template<typename T>
+    constexpr uint32_t componentSizeOf()
+    {
+        if constexpr (std::is_arithmetic_v<T>)
+            return sizeof(T);
+        else
+            return sizeof(typename T::value_type);
+    }
+
+    // replace the storage of large arrays with CompressedStorage
+    class CollectArrays : public vsg::Visitor
+    {
+    public:
+        uint32_t filters = FILTER_NONE;
+        uint32_t blockSize = 65536;
+        size_t minimumSize = 4096;
+
+        std::vector<vsg::ref_ptr<CompressedStorage>> storages;
+        std::set<const vsg::Object*> visited;
+
+        using vsg::Visitor::apply;
+
+        void apply(vsg::Object& object) override
+        {
+            if (visited.insert(&object).second) object.traverse(*this);
+        }
+
+        void apply(vsg::StateGroup& stateGroup) override
+        {
+            if (!visited.insert(&stateGroup).second) return;
+
+            for (auto& sc : stateGroup.stateCommands)
+            {
+                sc->accept(*this);
+            }
+
+            stateGroup.traverse(*this);
+        }
+
+        // vertex, index, image and terrain array types
+        void apply(vsg::ubyteArray& array) override { collect(array); }
+        void apply(vsg::ushortArray& array) override { collect(array); }
+        void apply(vsg::uintArray& array) override { collect(array); }
+        void apply(vsg::floatArray& array) override { collect(array); }
+        void apply(vsg::vec2Array& array) override { collect(array); }
+        void apply(vsg::vec3Array& array) override { collect(array); }
+        void apply(vsg::vec4Array& array) override { collect(array); }
+        void apply(vsg::dvec3Array& array) override { collect(array); }
+        void apply(vsg::ubvec4Array& array) override { collect(array); }
+        void apply(vsg::ubyteArray2D& array) override { collect(array); }
+        void apply(vsg::ushortArray2D& array) override { collect(array); }
+        void apply(vsg::floatArray2D& array) override { collect(array); }
+        void apply(vsg::vec4Array2D& array) override { collect(array); }
+        void apply(vsg::ubvec4Array2D& array) override { collect(array); }
+        void apply(vsg::ubyteArray3D& array) override { collect(array); }
+        void apply(vsg::floatArray3D& array) override { collect(array); }
+
+    protected:
+        template<typename T>
+        vsg::ref_ptr<CompressedStorage> createStorage(vsg::Data& data)
+        {
+            if (!visited.insert(&data).second) return {};
+            if (data.properties.stride != data.valueSize() || data.dataSize() < minimumSize) return {};
+
+            auto storage = CompressedStorage::create(static_cast<uint32_t>(data.dataSize()));
+            std::memcpy(storage->data(), data.dataPointer(), data.dataSize());
+
+            storage->layout.filters = filters;
+            storage->layout.componentSize = componentSizeOf<T>();
+            storage->layout.valueSize = static_cast<uint32_t>(data.valueSize());
+
+            // keep whole values within each block so filters see complete values
+            storage->blockSize = std::max(storage->layout.valueSize, (blockSize / storage->layout.valueSize) * storage->layout.valueSize);
+
+            storages.push_back(storage);
+            return storage;
+        }
+
+        template<typename T>
+        void collect(vsg::Array<T>& array)
+        {
+            if (auto storage = createStorage<T>(array))
+            {
+                auto properties = array.properties;
+                array.assign(storage, 0, properties.stride, array.width(), properties);
+            }
+        }
+
+        template<typename T>
+        void collect(vsg::Array2D<T>& array)
+        {
+            if (auto storage = createStorage<T>(array))
+            {
+                auto properties = array.properties;
+                array.assign(storage, 0, properties.stride, array.width(), array.height(), properties);
+            }
+        }
+
+        template<typename T>
+        void collect(vsg::Array3D<T>& array)
+        {
+            if (auto storage = createStorage<T>(array))
+            {
+                auto properties = array.properties;
+                array.assign(storage, 0, properties.stride, array.width(), array.height(), array.depth(), properties);
+            }
+        }
+    };
+} // namespace
+
+std::vector<uint8_t> CompressedStorage::encodeBlock(size_t i) const
+{
+    size_t begin = i * blockSize;
+    size_t end = std::min(begin + blockSize, dataSize());
+
+    std::vector<uint8_t> encoded;
+    compressBlock(data() + begin, end - begin, layout, encoded);
+    return encoded;
+}
+
+void CompressedStorage::assignEncodedBlocks(const std::vector<std::vector<uint8_t>>& encodedBlocks)
+{
+    size_t totalSize = 0;
+    for (auto& encoded : encodedBlocks) totalSize += encoded.size();
+
+    blockSizes = vsg::uintArray::create(static_cast<uint32_t>(encodedBlocks.size()));
+    blocks = vsg::ubyteArray::create(static_cast<uint32_t>(totalSize));
+
+    _blockOffsets.clear();
+    size_t offset = 0;
+    for (size_t i = 0; i < encodedBlocks.size(); ++i)
+    {
+        auto& encoded = encodedBlocks[i];
+        std::memcpy(blocks->data() + offset, encoded.data(), encoded.size());
+        blockSizes->set(i, static_cast<uint32_t>(encoded.size()));
+        _blockOffsets.push_back(offset);
+        offset += encoded.size();
+    }
+}
+
+bool CompressedStorage::decodeBlock(size_t i)
+{
+    if (i >= _blockOffsets.size()) return false;
+
+    size_t begin = i * blockSize;
+    size_t end = std::min(begin + blockSize, dataSize());
+
+    return decompressBlock(blocks->data() + _blockOffsets[i], blockSizes->at(i), data() + begin, end - begin, layout);
+}
+
+void CompressedStorage::read(vsg::Input& input)
+{
+    vsg::Object::read(input);
+
+    auto uncompressedSize = input.readValue<uint32_t>("size");
+    input.readValue<uint32_t>("filters", layout.filters);
+    input.readValue<uint32_t>("componentSize", layout.componentSize);
+    input.readValue<uint32_t>("valueSize", layout.valueSize);
+    input.readValue<uint32_t>("blockSize", blockSize);
+    input.readObject("blockSizes", blockSizes);
+    input.readObject("blocks", blocks);
+
+    // allocate the uncompressed data up front so arrays can be assigned as views into it before it's decoded
+    vsg::Data::Properties uncompressedProperties;
+    uncompressedProperties.allocatorType = vsg::ALLOCATOR_TYPE_NEW_DELETE;
+    assign(uncompressedSize, new uint8_t[uncompressedSize], uncompressedProperties);
+
+    // validate the block sizes against the compressed data before any decoding is attempted
+    _blockOffsets.clear();
+    if (!blockSizes || !blocks || blockSizes->size() != numBlocks())
+    {
+        vsg::warn("CompressedStorage::read() invalid block data.");
+        return;
+    }
+
+    size_t offset = 0;
+    for (auto compressedBlockSize : *blockSizes)
+    {
+        _blockOffsets.push_back(offset);
+        offset += compressedBlockSize;
+    }
+    if (offset > blocks->dataSize())
+    {
+        vsg::warn("CompressedStorage::read() block sizes exceed compressed data.");
+        _blockOffsets.clear();
+        return;
+    }
+
+    auto queue = input.options ? input.options->getObject<DecompressQueue>(decompressQueueKey) : nullptr;
+    if (queue)
+    {
+        queue->add(vsg::ref_ptr<CompressedStorage>(this));
+    }
+    else
+    {
+        for (size_t i = 0; i < _blockOffsets.size(); ++i)
+        {
+            if (!decodeBlock(i)) vsg::warn("CompressedStorage::read() failed to decode block ", i);
+        }
+    }
+}
+
+void CompressedStorage::write(vsg::Output& output) const
+{
+    vsg::Object::write(output);
+
+    output.writeValue<uint32_t>("size", size());
+    output.writeValue<uint32_t>("filters", layout.filters);
+    output.writeValue<uint32_t>("componentSize", layout.componentSize);
+    output.writeValue<uint32_t>("valueSize", layout.valueSize);
+    output.writeValue<uint32_t>("blockSize", blockSize);
+    output.writeObject("blockSizes", blockSizes);
+    output.writeObject("blocks", blocks);
+}
+
+void DecompressQueue::add(vsg::ref_ptr<CompressedStorage> storage) const
+{
+    std::scoped_lock<std::mutex> lock(_mutex);
+    _pending.push_back(storage);
+}
+
+CompressionStats DecompressQueue::decompress(uint32_t numThreads)
+{
+    std::vector<vsg::ref_ptr<CompressedStorage>> storages;
+    {
+        std::scoped_lock<std::mutex> lock(_mutex);
+        storages.swap(_pending);
+    }
+
+    CompressionStats stats;
+    std::vector<std::pair<CompressedStorage*, size_t>> jobs;
+    for (auto& storage : storages)
+    {
+        for (size_t i = 0; i < storage->numBlocks(); ++i) jobs.emplace_back(storage.get(), i);
+
+        stats.numArrays += 1;
+        stats.numBlocks += storage->numBlocks();
+        stats.uncompressedSize += storage->dataSize();
+        stats.compressedSize += storage->compressedSize();
+    }
+
+    std::atomic<size_t> numFailed{0};
+
+    auto start = vsg::clock::now();
+
+    runParallel(jobs.size(), numThreads, [&](size_t j) {
+        if (!jobs[j].first->decodeBlock(jobs[j].second)) ++numFailed;
+    });
+
+    stats.duration = std::chrono::duration<double, std::chrono::milliseconds::period>(vsg::clock::now() - start).count();
+
+    if (numFailed > 0) vsg::warn("DecompressQueue::decompress() failed to decode ", numFailed.load(), " blocks.");
+
+    return stats;
+}
+
+CompressionStats compressArrays(vsg::Object* object, uint32_t filters, uint32_t blockSize, uint32_t numThreads, size_t minimumSize)
+{
+    CompressionStats stats;
+    if (!object) return stats;
+
+    auto start = vsg::clock::now();
+
+    CollectArrays collectArrays;
+    collectArrays.filters = filters;
+    collectArrays.blockSize = blockSize;
+    collectArrays.minimumSize = minimumSize;
+    object->accept(collectArrays);
+
+    // spread the blocks of all the arrays across the threads
+    std::vector<std::vector<std::vector<uint8_t>>> encodedBlocks(collectArrays.storages.size());
+    std::vector<std::pair<size_t, size_t>> jobs;
+    for (size_t s = 0; s < collectArrays.storages.size(); ++s)
+    {
+        auto numBlocks = collectArrays.storages[s]->numBlocks();
+        encodedBlocks[s].resize(numBlocks);
+        for (size_t i = 0; i < numBlocks; ++i) jobs.emplace_back(s, i);
+    }
+
+    runParallel(jobs.size(), numThreads, [&](size_t j) {
+        auto [s, i] = jobs[j];
+        encodedBlocks[s][i] = collectArrays.storages[s]->encodeBlock(i);
+    });
+
+    for (size_t s = 0; s < collectArrays.storages.size(); ++s)
+    {
+        auto& storage = collectArrays.storages[s];
+        storage->assignEncodedBlocks(encodedBlocks[s]);
+
+        stats.numArrays += 1;
+        stats.numBlocks += storage->numBlocks();
+        stats.uncompressedSize += storage->dataSize();
+        stats.compressedSize += storage->compressedSize();
+    }
+
+    stats.duration = std::chrono::duration<double, std::chrono::milliseconds::period>(vsg::clock::now() - start).count();
+
+    return stats;
+}
+
+vsg::ref_ptr<vsg::Object> readCompressed(const vsg::Path& filename, vsg::ref_ptr<const vsg::Options> options, uint32_t numThreads, CompressionStats& stats)
+{
+    auto queue = DecompressQueue::create();
+
+    auto local_options = options ? vsg::Options::create(*options) : vsg::Options::create();
+    local_options->setObject(decompressQueueKey, queue);
+
+    vsg::VSG io;
+    auto object = io.read(filename, local_options);
+
+    // arrays are only valid once their blocks have been decoded so always complete decompression, even if the read failed part way.
+    stats = queue->decompress(numThreads);
+
+    return object;
+}
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <vsg/all.h>
+
+#include <mutex>
+
+#include "BlockCompression.h"
+
+// CompressedStorage provides the storage for an array that is written out in block compressed form, the array itself
+// is serialized as a view into the storage so the native .vsgb/.vsgt formats and ReaderWriter are used unchanged.
+class CompressedStorage : public vsg::Inherit<vsg::ubyteArray, CompressedStorage>
+{
+public:
+    CompressedStorage() {}
+    explicit CompressedStorage(uint32_t size) :
+        Inherit(size) {}
+
+    BlockLayout layout;
+    uint32_t blockSize = 65536;
+
+    // compressed size of each block and the concatenated compressed blocks
+    vsg::ref_ptr<vsg::uintArray> blockSizes;
+    vsg::ref_ptr<vsg::ubyteArray> blocks;
+
+    size_t numBlocks() const { return blockSize > 0 ? (dataSize() + blockSize - 1) / blockSize : 0; }
+    size_t compressedSize() const { return blocks ? blocks->dataSize() : 0; }
+
+    // per block encode/decode so that work can be spread across threads
+    std::vector<uint8_t> encodeBlock(size_t i) const;
+    void assignEncodedBlocks(const std::vector<std::vector<uint8_t>>& encodedBlocks);
+    bool decodeBlock(size_t i);
+
+    void read(vsg::Input& input) override;
+    void write(vsg::Output& output) const override;
+
+protected:
+    std::vector<size_t> _blockOffsets;
+};
+EVSG_type_name(CompressedStorage);
+
+struct CompressionStats
+{
+    size_t numArrays = 0;
+    size_t numBlocks = 0;
+    size_t uncompressedSize = 0;
+    size_t compressedSize = 0;
+    double duration = 0.0; // milliseconds
+
+    double ratio() const { return compressedSize > 0 ? static_cast<double>(uncompressedSize) / static_cast<double>(compressedSize) : 1.0; }
+    double throughput() const { return duration > 0.0 ? (static_cast<double>(uncompressedSize) / (1024.0 * 1024.0)) / (duration * 0.001) : 0.0; }
+};
+
+// DecompressQueue collects the CompressedStorage read from a file so all their blocks can be decoded in parallel once reading is complete.
+class DecompressQueue : public vsg::Inherit<vsg::Object, DecompressQueue>
+{
+public:
+    // const as readers only have access to the const Options that the queue is assigned to.
+    void add(vsg::ref_ptr<CompressedStorage> storage) const;
+
+    CompressionStats decompress(uint32_t numThreads);
+
+protected:
+    mutable std::mutex _mutex;
+    mutable std::vector<vsg::ref_ptr<CompressedStorage>> _pending;
+};
+
+// reassign all arrays in the scene graph of at least minimumSize bytes to be views into a compressed storage, encoding blocks in parallel.
+extern CompressionStats compressArrays(vsg::Object* object, uint32_t filters, uint32_t blockSize, uint32_t numThreads, size_t minimumSize = 4096);
+
+// read a native .vsgb/.vsgt file, decoding any compressed arrays in parallel after the file is read.
+extern vsg::ref_ptr<vsg::Object> readCompressed(const vsg::Path& filename, vsg::ref_ptr<const vsg::Options> options, uint32_t numThreads, CompressionStats& stats);
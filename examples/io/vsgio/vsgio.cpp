@@ -2,8 +2,11 @@
 
 #include <fstream>
 #include <iostream>
+#include <thread>
 #include <unordered_map>
 
+#include "CompressedStorage.h"
+
 vsg::ref_ptr<vsg::Node> createQuadTree(unsigned int numLevels, vsg::Node* sharedLeaf)
 {
     if (numLevels == 0) return sharedLeaf ? vsg::ref_ptr<vsg::Node>(sharedLeaf) : vsg::Node::create();
@@ -43,6 +46,12 @@ int main(int argc, char** argv)
     auto useQuadGroup = arguments.read("-q");
     auto inputFilename = arguments.value(std::string(), "-i");
     auto outputFilename = arguments.value(std::string(), "-o");
+    auto compress = arguments.read({"--compress", "-c"});
+    uint32_t filters = FILTER_NONE;
+    if (arguments.read("--delta")) filters |= FILTER_DELTA;
+    if (arguments.read("--shuffle")) filters |= FILTER_SHUFFLE;
+    auto blockSize = arguments.value<uint32_t>(65536, "--block-size");
+    auto numThreads = arguments.value<uint32_t>(std::max(1u, std::thread::hardware_concurrency()), "--threads");
 
     if (arguments.errors()) return arguments.writeErrorMessages(std::cerr);
 
@@ -89,13 +98,25 @@ int main(int argc, char** argv)
     {
         if (vsg::fileExists(inputFilename))
         {
-            vsg::VSG io;
-            object = io.read(inputFilename);
+            auto startRead = vsg::clock::now();
+
+            CompressionStats decompressionStats;
+            object = readCompressed(inputFilename, {}, numThreads, decompressionStats);
             if (!object)
             {
                 std::cout << "Warning: file not read : " << inputFilename << std::endl;
                 return 1;
             }
+
+            auto readTime = std::chrono::duration<double, std::chrono::milliseconds::period>(vsg::clock::now() - startRead).count();
+            std::cerr << "read time = " << readTime << "ms" << std::endl;
+
+            if (decompressionStats.numArrays > 0)
+            {
+                std::cerr << "compressed arrays = " << decompressionStats.numArrays << ", blocks = " << decompressionStats.numBlocks << std::endl;
+                std::cerr << "compression ratio = " << decompressionStats.ratio() << " (" << decompressionStats.uncompressedSize << " / " << decompressionStats.compressedSize << " bytes)" << std::endl;
+                std::cerr << "decode time = " << decompressionStats.duration << "ms, " << decompressionStats.throughput() << "MB/s using " << numThreads << " threads" << std::endl;
+            }
         }
         else
         {
@@ -104,6 +125,14 @@ int main(int argc, char** argv)
         }
     }
 
+    if (object && compress)
+    {
+        auto compressionStats = compressArrays(object, filters, blockSize, numThreads);
+        std::cerr << "compressed arrays = " << compressionStats.numArrays << ", blocks = " << compressionStats.numBlocks << std::endl;
+        std::cerr << "compression ratio = " << compressionStats.ratio() << " (" << compressionStats.uncompressedSize << " / " << compressionStats.compressedSize << " bytes)" << std::endl;
+        std::cerr << "encode time = " << compressionStats.duration << "ms, " << compressionStats.throughput() << "MB/s using " << numThreads << " threads" << std::endl;
+    }
+
     if (object)
     {
         if (outputFilename.empty())
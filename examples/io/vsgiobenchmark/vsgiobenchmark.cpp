@@ -0,0 +1,376 @@
+#include <vsg/all.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <sstream>
+
+#if defined(__linux__)
+#    include <fcntl.h>
+#    include <unistd.h>
+#endif
+
+struct Scene
+{
+    std::string name;
+    vsg::ref_ptr<vsg::Object> object;
+};
+
+struct Result
+{
+    std::string name;
+    std::map<std::string, double> metrics;
+};
+
+vsg::ref_ptr<vsg::Node> createQuadTree(unsigned int numLevels, vsg::Node* sharedLeaf)
+{
+    if (numLevels == 0) return sharedLeaf ? vsg::ref_ptr<vsg::Node>(sharedLeaf) : vsg::Node::create();
+
+    vsg::ref_ptr<vsg::Group> t = vsg::Group::create();
+
+    --numLevels;
+
+    t->children = {{createQuadTree(numLevels, sharedLeaf),
+                    createQuadTree(numLevels, sharedLeaf),
+                    createQuadTree(numLevels, sharedLeaf),
+                    createQuadTree(numLevels, sharedLeaf)}};
+
+    return t;
+}
+
+vsg::ref_ptr<vsg::Node> createWideGroup(unsigned int numChildren, vsg::Node* sharedLeaf)
+{
+    auto group = vsg::Group::create();
+    for (unsigned int i = 0; i < numChildren; ++i)
+    {
+        auto transform = vsg::MatrixTransform::create(vsg::translate(double(i), 0.0, 0.0));
+        transform->addChild(sharedLeaf ? vsg::ref_ptr<vsg::Node>(sharedLeaf) : vsg::Node::create());
+        group->addChild(transform);
+    }
+    return group;
+}
+
+vsg::ref_ptr<vsg::Node> createLargeArrays(uint32_t numVertices)
+{
+    auto vertices = vsg::vec3Array::create(numVertices);
+    auto normals = vsg::vec3Array::create(numVertices);
+    auto texcoords = vsg::vec2Array::create(numVertices);
+    auto indices = vsg::uintArray::create(numVertices);
+
+    for (uint32_t i = 0; i < numVertices; ++i)
+    {
+        float t = static_cast<float>(i) / static_cast<float>(numVertices);
+        vertices->set(i, vsg::vec3(std::cos(t * 100.0f), std::sin(t * 100.0f), t));
+        normals->set(i, vsg::vec3(std::cos(t * 100.0f), std::sin(t * 100.0f), 0.0f));
+        texcoords->set(i, vsg::vec2(t, 1.0f - t));
+        indices->set(i, i);
+    }
+
+    auto vid = vsg::VertexIndexDraw::create();
+    vid->assignArrays(vsg::DataList{vertices, normals, texcoords});
+    vid->assignIndices(indices);
+    vid->indexCount = numVertices;
+    vid->instanceCount = 1;
+    return vid;
+}
+
+vsg::ref_ptr<vsg::Object> createTextures(uint32_t numTextures, uint32_t size, bool shared)
+{
+    auto createImage = [&](uint32_t seed) {
+        auto image = vsg::ubvec4Array2D::create(size, size, vsg::Data::Properties{VK_FORMAT_R8G8B8A8_UNORM});
+        for (uint32_t r = 0; r < size; ++r)
+        {
+            for (uint32_t c = 0; c < size; ++c)
+            {
+                image->set(c, r, vsg::ubvec4(uint8_t(c * 8 + seed), uint8_t(r * 8), uint8_t(seed), 255));
+            }
+        }
+        return image;
+    };
+
+    auto sampler = vsg::Sampler::create();
+    auto sharedImage = shared ? createImage(0) : vsg::ref_ptr<vsg::ubvec4Array2D>();
+
+    auto objects = vsg::Objects::create();
+    for (uint32_t i = 0; i < numTextures; ++i)
+    {
+        auto image = shared ? sharedImage : createImage(i);
+        objects->addChild(vsg::DescriptorImage::create(sampler, image, 0, 0, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER));
+    }
+    return objects;
+}
+
+vsg::ref_ptr<vsg::Node> createText(uint32_t numLabels, vsg::ref_ptr<vsg::Font> font)
+{
+    auto group = vsg::Group::create();
+    for (uint32_t i = 0; i < numLabels; ++i)
+    {
+        auto layout = vsg::StandardLayout::create();
+        layout->position = vsg::vec3(0.0f, 0.0f, static_cast<float>(i));
+        layout->horizontal = vsg::vec3(1.0f, 0.0f, 0.0f);
+        layout->vertical = vsg::vec3(0.0f, 0.0f, 1.0f);
+        layout->color = vsg::vec4(1.0f, 1.0f, 1.0f, 1.0f);
+
+        auto text = vsg::Text::create();
+        text->font = font;
+        text->layout = layout;
+        text->text = vsg::stringValue::create(vsg::make_string("Label number ", i));
+        group->addChild(text);
+    }
+    return group;
+}
+
+// ask the OS to drop the file from its page cache so the next read has to go to the storage device.
+bool evictFromFileCache(const vsg::Path& filename)
+{
+#if defined(__linux__)
+    int fd = ::open(filename.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+
+    ::fdatasync(fd);
+    int result = ::posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+    ::close(fd);
+    return result == 0;
+#else
+    (void)filename;
+    return false;
+#endif
+}
+
+size_t fileSize(const vsg::Path& filename)
+{
+    std::ifstream fin(filename.c_str(), std::ios::in | std::ios::binary | std::ios::ate);
+    return fin ? static_cast<size_t>(fin.tellg()) : 0;
+}
+
+double median(std::vector<double> times)
+{
+    if (times.empty()) return 0.0;
+    std::sort(times.begin(), times.end());
+    return times[times.size() / 2];
+}
+
+void writeJSON(std::ostream& out, const std::vector<Result>& results, unsigned int numIterations)
+{
+    out << std::setprecision(12);
+    out << "{\n";
+    out << "  \"iterations\": " << numIterations << ",\n";
+    out << "  \"results\": [\n";
+    for (size_t r = 0; r < results.size(); ++r)
+    {
+        auto& result = results[r];
+        out << "    {\"name\": \"" << result.name << "\"";
+        for (auto& [key, value] : result.metrics) out << ", \"" << key << "\": " << value;
+        out << "}" << (r + 1 < results.size() ? "," : "") << "\n";
+    }
+    out << "  ]\n";
+    out << "}\n";
+}
+
+// read the results written by writeJSON(), only the flat objects of the results array are supported.
+std::map<std::string, std::map<std::string, double>> readJSON(const vsg::Path& filename)
+{
+    std::map<std::string, std::map<std::string, double>> baseline;
+
+    std::ifstream fin(filename.c_str());
+    if (!fin) return baseline;
+
+    std::stringstream sstr;
+    sstr << fin.rdbuf();
+    std::string json = sstr.str();
+
+    auto pos = json.find("\"results\"");
+    if (pos == std::string::npos) return baseline;
+
+    while ((pos = json.find('{', pos)) != std::string::npos)
+    {
+        auto end = json.find('}', pos);
+        if (end == std::string::npos) break;
+
+        std::string name;
+        std::map<std::string, double> metrics;
+
+        auto entry = json.substr(pos + 1, end - pos - 1);
+        size_t p = 0;
+        while ((p = entry.find('"', p)) != std::string::npos)
+        {
+            auto keyEnd = entry.find('"', p + 1);
+            auto colon = entry.find(':', keyEnd);
+            if (keyEnd == std::string::npos || colon == std::string::npos) break;
+
+            auto key = entry.substr(p + 1, keyEnd - p - 1);
+            auto valueStart = entry.find_first_not_of(" \t\r\n", colon + 1);
+            if (valueStart == std::string::npos) break;
+
+            if (entry[valueStart] == '"')
+            {
+                auto valueEnd = entry.find('"', valueStart + 1);
+                if (valueEnd == std::string::npos) break;
+                if (key == "name") name = entry.substr(valueStart + 1, valueEnd - valueStart - 1);
+                p = valueEnd + 1;
+            }
+            else
+            {
+                auto valueEnd = entry.find_first_of(",}", valueStart);
+                metrics[key] = std::atof(entry.substr(valueStart, valueEnd - valueStart).c_str());
+                p = (valueEnd == std::string::npos) ? entry.size() : valueEnd;
+            }
+        }
+
+        if (!name.empty()) baseline[name] = metrics;
+        pos = end + 1;
+    }
+
+    return baseline;
+}
+
+int main(int argc, char** argv)
+{
+    vsg::CommandLine arguments(&argc, argv);
+
+    auto options = vsg::Options::create();
+    options->paths = vsg::getEnvPaths("VSG_FILE_PATH");
+
+    auto numIterations = arguments.value(5u, {"--iterations", "-n"});
+    auto numLevels = arguments.value(8u, {"--levels", "-l"});
+    auto numChildren = arguments.value(100000u, "--width");
+    auto numVertices = arguments.value(1000000u, "--vertices");
+    auto numTextures = arguments.value(1000u, "--textures");
+    auto textureSize = arguments.value(32u, "--texture-size");
+    auto numLabels = arguments.value(1000u, "--labels");
+    auto fontFilename = arguments.value(vsg::Path("fonts/times.vsgb"), "--font");
+    auto directory = arguments.value(vsg::Path("."), "--dir");
+    auto jsonFilename = arguments.value(vsg::Path(), {"--json", "-o"});
+    auto baselineFilename = arguments.value(vsg::Path(), {"--baseline", "-b"});
+    auto tolerance = arguments.value(0.1, "--tolerance");
+    bool coldReads = !arguments.read("--warm-only");
+
+    if (arguments.errors()) return arguments.writeErrorMessages(std::cerr);
+
+    auto font = vsg::read_cast<vsg::Font>(fontFilename, options);
+    if (!font) std::cout << "Warning: unable to read font " << fontFilename << ", text labels will be written without a font." << std::endl;
+
+    std::vector<Scene> scenes;
+    auto leaf = vsg::Node::create();
+    scenes.push_back(Scene{"quadtree-shared", createQuadTree(numLevels, leaf)});
+    scenes.push_back(Scene{"quadtree-unshared", createQuadTree(numLevels, nullptr)});
+    scenes.push_back(Scene{"widegroup-shared", createWideGroup(numChildren, leaf)});
+    scenes.push_back(Scene{"widegroup-unshared", createWideGroup(numChildren, nullptr)});
+    scenes.push_back(Scene{"largearrays", createLargeArrays(numVertices)});
+    scenes.push_back(Scene{"textures-shared", createTextures(numTextures, textureSize, true)});
+    scenes.push_back(Scene{"textures-unshared", createTextures(numTextures, textureSize, false)});
+    scenes.push_back(Scene{"text", createText(numLabels, font)});
+
+    std::vector<Result> results;
+    for (auto& scene : scenes)
+    {
+        for (auto extension : {".vsgt", ".vsgb"})
+        {
+            Result result;
+            result.name = scene.name + extension;
+
+            auto filename = directory / vsg::Path("vsgiobenchmark_" + result.name);
+
+            std::vector<double> writeTimes, warmReadTimes, coldReadTimes;
+            for (unsigned int i = 0; i < numIterations; ++i)
+            {
+                auto start = vsg::clock::now();
+                if (!vsg::write(scene.object, filename, options))
+                {
+                    std::cout << "Error: unable to write " << filename << std::endl;
+                    return 1;
+                }
+                writeTimes.push_back(std::chrono::duration<double, std::chrono::milliseconds::period>(vsg::clock::now() - start).count());
+
+                // read once straight after writing so the file is in the OS page cache
+                start = vsg::clock::now();
+                auto object = vsg::read(filename, options);
+                warmReadTimes.push_back(std::chrono::duration<double, std::chrono::milliseconds::period>(vsg::clock::now() - start).count());
+                if (!object)
+                {
+                    std::cout << "Error: unable to read " << filename << std::endl;
+                    return 1;
+                }
+                object = {};
+
+                if (coldReads && evictFromFileCache(filename))
+                {
+                    start = vsg::clock::now();
+                    object = vsg::read(filename, options);
+                    coldReadTimes.push_back(std::chrono::duration<double, std::chrono::milliseconds::period>(vsg::clock::now() - start).count());
+                }
+            }
+
+            result.metrics["size_bytes"] = static_cast<double>(fileSize(filename));
+            result.metrics["write_ms"] = median(writeTimes);
+            result.metrics["read_warm_ms"] = median(warmReadTimes);
+            if (!coldReadTimes.empty()) result.metrics["read_cold_ms"] = median(coldReadTimes);
+
+            std::cout << std::left << std::setw(28) << result.name;
+            for (auto& [key, value] : result.metrics) std::cout << "  " << key << " = " << std::setw(10) << value;
+            std::cout << std::endl;
+
+            std::error_code ec;
+            std::filesystem::remove(std::filesystem::path(filename.native()), ec);
+
+            results.push_back(result);
+        }
+    }
+
+    if (jsonFilename)
+    {
+        std::ofstream fout(jsonFilename.c_str());
+        writeJSON(fout, results, numIterations);
+        std::cout << "Results written to " << jsonFilename << std::endl;
+    }
+
+    if (baselineFilename)
+    {
+        auto baseline = readJSON(baselineFilename);
+        if (baseline.empty())
+        {
+            std::cout << "Error: unable to read baseline " << baselineFilename << std::endl;
+            return 1;
+        }
+
+        // report each metric relative to the baseline, flagging any that are worse by more than the tolerance.
+        unsigned int numRegressions = 0;
+        std::cout << "\nComparison against baseline " << baselineFilename << ", tolerance " << tolerance * 100.0 << "%" << std::endl;
+        for (auto& result : results)
+        {
+            auto itr = baseline.find(result.name);
+            if (itr == baseline.end())
+            {
+                std::cout << std::left << std::setw(28) << result.name << "  not in baseline" << std::endl;
+                continue;
+            }
+
+            for (auto& [key, value] : result.metrics)
+            {
+                auto baseline_itr = itr->second.find(key);
+                if (baseline_itr == itr->second.end() || baseline_itr->second <= 0.0) continue;
+
+                double ratio = value / baseline_itr->second;
+                bool regression = ratio > (1.0 + tolerance);
+                if (regression) ++numRegressions;
+
+                std::cout << std::left << std::setw(28) << result.name << "  " << std::setw(14) << key << " " << std::setw(10) << baseline_itr->second << " -> " << std::setw(10) << value
+                          << " (" << std::fixed << std::setprecision(1) << (ratio - 1.0) * 100.0 << "%)" << std::defaultfloat << std::setprecision(6) << (regression ? "  REGRESSION" : "") << std::endl;
+            }
+        }
+
+        if (numRegressions > 0)
+        {
+            std::cout << numRegressions << " regressions found." << std::endl;
+            return 1;
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,342 @@
+#include "BinaryLog.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <map>
+
+namespace
+{
+    std::atomic<uint64_t> s_nextLoggerID{1};
+
+    // all BinaryFormat registered in the application, shared by all BinaryLogger so format ids are global.
+    struct FormatRegistry
+    {
+        std::mutex mutex;
+        std::vector<std::pair<vsg::Logger::Level, std::string>> formats;
+
+        static FormatRegistry& instance()
+        {
+            static FormatRegistry s_registry;
+            return s_registry;
+        }
+    };
+
+    uint32_t registerFormat(vsg::Logger::Level level, const char* format)
+    {
+        auto& registry = FormatRegistry::instance();
+        std::scoped_lock<std::mutex> lock(registry.mutex);
+        registry.formats.emplace_back(level, format);
+        return static_cast<uint32_t>(registry.formats.size() - 1);
+    }
+
+    template<typename T>
+    void write(std::ostream& out, const T& value)
+    {
+        out.write(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+
+    // bounds checked reading of a chunk's payload
+    struct ChunkReader
+    {
+        const std::vector<uint8_t>& data;
+        size_t pos = 0;
+
+        bool remaining() const { return pos < data.size(); }
+
+        template<typename T>
+        bool read(T& value)
+        {
+            if (pos + sizeof(T) > data.size()) return false;
+            std::memcpy(&value, data.data() + pos, sizeof(T));
+            pos += sizeof(T);
+            return true;
+        }
+
+        bool read(std::string& str, size_t size)
+        {
+            if (pos + size > data.size()) return false;
+            str.assign(reinterpret_cast<const char*>(data.data()) + pos, size);
+            pos += size;
+            return true;
+        }
+    };
+
+    template<typename T>
+    bool readVector(ChunkReader& reader, std::string& str)
+    {
+        uint8_t size = 0;
+        if (!reader.read(size)) return false;
+
+        // match the t_vec ostream operators used by vsg::Logger
+        std::ostringstream sstr;
+        for (uint8_t i = 0; i < size; ++i)
+        {
+            T value;
+            if (!reader.read(value)) return false;
+            if (i > 0) sstr << " ";
+            sstr << value;
+        }
+        str = sstr.str();
+        return true;
+    }
+
+    bool readArgument(ChunkReader& reader, std::string& str)
+    {
+        uint8_t type = 0;
+        if (!reader.read(type)) return false;
+
+        switch (type)
+        {
+        case (BinaryLogger::INT_ARG): {
+            int64_t value;
+            if (!reader.read(value)) return false;
+            str = std::to_string(value);
+            return true;
+        }
+        case (BinaryLogger::UINT_ARG): {
+            uint64_t value;
+            if (!reader.read(value)) return false;
+            str = std::to_string(value);
+            return true;
+        }
+        case (BinaryLogger::DOUBLE_ARG): {
+            double value;
+            if (!reader.read(value)) return false;
+            std::ostringstream sstr;
+            sstr << value;
+            str = sstr.str();
+            return true;
+        }
+        case (BinaryLogger::BOOL_ARG): {
+            uint8_t value;
+            if (!reader.read(value)) return false;
+            str = value ? "1" : "0";
+            return true;
+        }
+        case (BinaryLogger::STRING_ARG): {
+            uint32_t size;
+            return reader.read(size) && reader.read(str, size);
+        }
+        case (BinaryLogger::FLOAT_VECTOR_ARG): return readVector<float>(reader, str);
+        case (BinaryLogger::DOUBLE_VECTOR_ARG): return readVector<double>(reader, str);
+        default: return false;
+        }
+    }
+
+    std::string substitute(const std::string& format, const std::vector<std::string>& arguments)
+    {
+        std::string message;
+        size_t argument = 0;
+        for (size_t i = 0; i < format.size(); ++i)
+        {
+            if (format[i] == '{' && i + 1 < format.size() && format[i + 1] == '}' && argument < arguments.size())
+            {
+                message += arguments[argument++];
+                ++i;
+            }
+            else
+            {
+                message.push_back(format[i]);
+            }
+        }
+
+        // any arguments without a matching {} are appended, as vsg::info(..) would
+        for (; argument < arguments.size(); ++argument) message += arguments[argument];
+
+        return message;
+    }
+} // namespace
+
+BinaryFormat::BinaryFormat(vsg::Logger::Level in_level, const char* in_format) :
+    level(in_level),
+    format(in_format),
+    id(registerFormat(in_level, in_format))
+{
+}
+
+BinaryLogger::BinaryLogger(const vsg::Path& filename, size_t in_bufferSize) :
+    bufferSize(in_bufferSize),
+    _id(s_nextLoggerID++),
+    _fout(filename.c_str(), std::ios::out | std::ios::binary)
+{
+    _fout.write(fileIdentifier, std::strlen(fileIdentifier));
+}
+
+BinaryLogger::~BinaryLogger()
+{
+    flush();
+}
+
+BinaryLogger::ThreadBuffer& BinaryLogger::getThreadBuffer()
+{
+    // each thread caches its buffers so only the first message from a thread takes the buffers lock.
+    thread_local std::vector<std::pair<uint64_t, ThreadBuffer*>> s_threadBuffers;
+    for (auto& [id, threadBuffer] : s_threadBuffers)
+    {
+        if (id == _id) return *threadBuffer;
+    }
+
+    std::scoped_lock<std::mutex> lock(_threadBuffersMutex);
+    auto threadBuffer = std::make_unique<ThreadBuffer>();
+    threadBuffer->threadIndex = static_cast<uint32_t>(_threadBuffers.size());
+    threadBuffer->data.reserve(bufferSize + 1024);
+    s_threadBuffers.emplace_back(_id, threadBuffer.get());
+    _threadBuffers.push_back(std::move(threadBuffer));
+    return *_threadBuffers.back();
+}
+
+void BinaryLogger::writeNewFormats()
+{
+    auto& registry = FormatRegistry::instance();
+    std::scoped_lock<std::mutex> lock(registry.mutex);
+    for (; _numFormatsWritten < registry.formats.size(); ++_numFormatsWritten)
+    {
+        auto& [formatLevel, format] = registry.formats[_numFormatsWritten];
+
+        write(_fout, FORMAT_CHUNK);
+        write(_fout, static_cast<uint32_t>(sizeof(uint32_t) + sizeof(uint8_t) + format.size()));
+        write(_fout, static_cast<uint32_t>(_numFormatsWritten));
+        write(_fout, static_cast<uint8_t>(formatLevel));
+        _fout.write(format.data(), format.size());
+    }
+}
+
+void BinaryLogger::writeChunk(ThreadBuffer& threadBuffer)
+{
+    std::scoped_lock<std::mutex> lock(_fileMutex);
+
+    // formats are registered before any records that reference them so writing them first keeps the file self describing.
+    writeNewFormats();
+
+    write(_fout, RECORDS_CHUNK);
+    write(_fout, static_cast<uint32_t>(sizeof(uint32_t) + threadBuffer.data.size()));
+    write(_fout, threadBuffer.threadIndex);
+    _fout.write(reinterpret_cast<const char*>(threadBuffer.data.data()), threadBuffer.data.size());
+
+    threadBuffer.data.clear();
+}
+
+void BinaryLogger::flush()
+{
+    std::scoped_lock<std::mutex> lock(_threadBuffersMutex);
+    for (auto& threadBuffer : _threadBuffers)
+    {
+        std::scoped_lock<std::mutex> bufferLock(threadBuffer->mutex);
+        if (!threadBuffer->data.empty()) writeChunk(*threadBuffer);
+    }
+
+    std::scoped_lock<std::mutex> fileLock(_fileMutex);
+    _fout.flush();
+}
+
+size_t decodeBinaryLog(const vsg::Path& filename, vsg::Logger& logger, bool includeTimestamps)
+{
+    std::ifstream fin(filename.c_str(), std::ios::in | std::ios::binary);
+    if (!fin)
+    {
+        vsg::warn("decodeBinaryLog() unable to open ", filename);
+        return 0;
+    }
+
+    std::string identifier(std::strlen(BinaryLogger::fileIdentifier), '\0');
+    fin.read(identifier.data(), identifier.size());
+    if (!fin || identifier != BinaryLogger::fileIdentifier)
+    {
+        vsg::warn("decodeBinaryLog() ", filename, " is not a binary log file.");
+        return 0;
+    }
+
+    struct Format
+    {
+        vsg::Logger::Level level = vsg::Logger::LOGGER_INFO;
+        std::string format;
+    };
+
+    struct Record
+    {
+        int64_t time;
+        uint32_t threadIndex;
+        uint32_t formatID;
+        std::vector<std::string> arguments;
+    };
+
+    std::map<uint32_t, Format> formats;
+    std::vector<Record> records;
+
+    std::vector<uint8_t> payload;
+    uint32_t chunkType = 0, chunkSize = 0;
+    while (fin.read(reinterpret_cast<char*>(&chunkType), sizeof(chunkType)) && fin.read(reinterpret_cast<char*>(&chunkSize), sizeof(chunkSize)))
+    {
+        payload.resize(chunkSize);
+        if (!fin.read(reinterpret_cast<char*>(payload.data()), chunkSize))
+        {
+            vsg::warn("decodeBinaryLog() truncated chunk at end of file.");
+            break;
+        }
+
+        ChunkReader reader{payload};
+        bool valid = true;
+        if (chunkType == BinaryLogger::FORMAT_CHUNK)
+        {
+            uint32_t id;
+            uint8_t formatLevel;
+            Format format;
+            valid = reader.read(id) && reader.read(formatLevel) && reader.read(format.format, payload.size() - reader.pos);
+            format.level = vsg::Logger::Level(formatLevel);
+            if (valid) formats[id] = format;
+        }
+        else if (chunkType == BinaryLogger::RECORDS_CHUNK)
+        {
+            uint32_t threadIndex;
+            valid = reader.read(threadIndex);
+            while (valid && reader.remaining())
+            {
+                Record record{0, threadIndex, 0, {}};
+                uint8_t numArguments = 0;
+                valid = reader.read(record.formatID) && reader.read(record.time) && reader.read(numArguments);
+
+                record.arguments.resize(numArguments);
+                for (auto& argument : record.arguments)
+                {
+                    if (valid) valid = readArgument(reader, argument);
+                }
+
+                if (valid) records.push_back(std::move(record));
+            }
+        }
+
+        if (!valid)
+        {
+            vsg::warn("decodeBinaryLog() invalid chunk, chunkType = ", chunkType, ", chunkSize = ", chunkSize);
+            break;
+        }
+    }
+
+    // each chunk is from a single thread so merge them into timestamp order
+    std::stable_sort(records.begin(), records.end(), [](const Record& lhs, const Record& rhs) { return lhs.time < rhs.time; });
+
+    int64_t startTime = records.empty() ? 0 : records.front().time;
+    for (auto& record : records)
+    {
+        auto itr = formats.find(record.formatID);
+        if (itr == formats.end())
+        {
+            logger.warn("decodeBinaryLog() no format for id ", record.formatID);
+            continue;
+        }
+
+        auto message = substitute(itr->second.format, record.arguments);
+        if (includeTimestamps)
+        {
+            double time = static_cast<double>(record.time - startTime) * 1e-6;
+            logger.log(itr->second.level, "thread ", record.threadIndex, " | ", time, "ms | ", message);
+        }
+        else
+        {
+            logger.log(itr->second.level, "thread ", record.threadIndex, " | ", message);
+        }
+    }
+
+    return records.size();
+}
@@ -0,0 +1,169 @@
+#pragma once
+
+#include <vsg/all.h>
+
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <type_traits>
+
+// BinaryFormat is declared once per message site, typically as a static, registering the format string so that log records
+// only need to reference it by id. Each {} in the format is replaced by the next argument when the log is decoded.
+//
+//     static const BinaryFormat s_lineNumber(vsg::Logger::LOGGER_INFO, "line number {}");
+//     binaryLogger->log(s_lineNumber, i);
+//
+struct BinaryFormat
+{
+    BinaryFormat(vsg::Logger::Level in_level, const char* in_format);
+
+    const vsg::Logger::Level level;
+    const char* const format;
+    const uint32_t id;
+};
+
+// BinaryLogger writes compact records containing the format id, timestamp and raw argument values, leaving all the
+// formatting to the offline decoder. Each thread appends to its own buffer which is written to file as a single chunk once full.
+class BinaryLogger : public vsg::Inherit<vsg::Object, BinaryLogger>
+{
+public:
+    explicit BinaryLogger(const vsg::Path& filename, size_t in_bufferSize = 65536);
+    ~BinaryLogger();
+
+    vsg::Logger::Level level = vsg::Logger::LOGGER_ALL;
+    const size_t bufferSize;
+
+    bool valid() const { return _fout.good(); }
+
+    template<typename... Args>
+    void log(const BinaryFormat& format, Args&&... args)
+    {
+        if (level > format.level) return;
+
+        auto& threadBuffer = getThreadBuffer();
+        std::scoped_lock<std::mutex> lock(threadBuffer.mutex); // uncontended other than when flush() is called
+
+        auto& buffer = threadBuffer.data;
+        encode(buffer, format.id);
+        encode(buffer, static_cast<int64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(vsg::clock::now().time_since_epoch()).count()));
+        buffer.push_back(static_cast<uint8_t>(sizeof...(Args)));
+        (encodeArgument(buffer, args), ...);
+
+        if (buffer.size() >= bufferSize) writeChunk(threadBuffer);
+    }
+
+    // write all buffered records to file.
+    void flush();
+
+    enum ChunkType : uint32_t
+    {
+        FORMAT_CHUNK = 1,
+        RECORDS_CHUNK = 2
+    };
+
+    enum ArgumentType : uint8_t
+    {
+        INT_ARG,
+        UINT_ARG,
+        DOUBLE_ARG,
+        BOOL_ARG,
+        STRING_ARG,
+        FLOAT_VECTOR_ARG,
+        DOUBLE_VECTOR_ARG
+    };
+
+    static constexpr const char* fileIdentifier = "vsgblog1";
+
+protected:
+    struct ThreadBuffer
+    {
+        uint32_t threadIndex = 0;
+        std::mutex mutex;
+        std::vector<uint8_t> data;
+    };
+
+    ThreadBuffer& getThreadBuffer();
+    void writeChunk(ThreadBuffer& threadBuffer);
+    void writeNewFormats();
+
+    template<typename T>
+    static void encode(std::vector<uint8_t>& buffer, const T& value)
+    {
+        auto ptr = reinterpret_cast<const uint8_t*>(&value);
+        buffer.insert(buffer.end(), ptr, ptr + sizeof(T));
+    }
+
+    static void encodeString(std::vector<uint8_t>& buffer, const std::string_view& str)
+    {
+        buffer.push_back(STRING_ARG);
+        encode(buffer, static_cast<uint32_t>(str.size()));
+        buffer.insert(buffer.end(), str.begin(), str.end());
+    }
+
+    template<typename T>
+    static void encodeArgument(std::vector<uint8_t>& buffer, const T& value)
+    {
+        using type = std::decay_t<T>;
+        if constexpr (std::is_same_v<type, bool>)
+        {
+            buffer.push_back(BOOL_ARG);
+            buffer.push_back(value ? 1 : 0);
+        }
+        else if constexpr (std::is_same_v<type, char>)
+        {
+            encodeString(buffer, std::string_view(&value, 1));
+        }
+        else if constexpr (std::is_integral_v<type> && std::is_signed_v<type>)
+        {
+            buffer.push_back(INT_ARG);
+            encode(buffer, static_cast<int64_t>(value));
+        }
+        else if constexpr (std::is_integral_v<type>)
+        {
+            buffer.push_back(UINT_ARG);
+            encode(buffer, static_cast<uint64_t>(value));
+        }
+        else if constexpr (std::is_floating_point_v<type>)
+        {
+            buffer.push_back(DOUBLE_ARG);
+            encode(buffer, static_cast<double>(value));
+        }
+        else if constexpr (std::is_convertible_v<type, std::string_view>)
+        {
+            encodeString(buffer, std::string_view(value));
+        }
+        else if constexpr (std::is_same_v<type, vsg::vec2> || std::is_same_v<type, vsg::vec3> || std::is_same_v<type, vsg::vec4>)
+        {
+            buffer.push_back(FLOAT_VECTOR_ARG);
+            buffer.push_back(static_cast<uint8_t>(sizeof(type) / sizeof(value[0])));
+            for (size_t i = 0; i < sizeof(type) / sizeof(value[0]); ++i) encode(buffer, value[i]);
+        }
+        else if constexpr (std::is_same_v<type, vsg::dvec2> || std::is_same_v<type, vsg::dvec3> || std::is_same_v<type, vsg::dvec4>)
+        {
+            buffer.push_back(DOUBLE_VECTOR_ARG);
+            buffer.push_back(static_cast<uint8_t>(sizeof(type) / sizeof(value[0])));
+            for (size_t i = 0; i < sizeof(type) / sizeof(value[0]); ++i) encode(buffer, value[i]);
+        }
+        else
+        {
+            // types without a binary encoding fall back to being formatted on the calling thread
+            std::ostringstream sstr;
+            sstr << value;
+            encodeString(buffer, sstr.str());
+        }
+    }
+
+    const uint64_t _id;
+
+    std::mutex _fileMutex;
+    std::ofstream _fout;
+    size_t _numFormatsWritten = 0;
+
+    std::mutex _threadBuffersMutex;
+    std::vector<std::unique_ptr<ThreadBuffer>> _threadBuffers;
+};
+
+// decode a binary log file, passing each message in timestamp order to the logger as if it had been logged directly.
+// returns the number of records decoded.
+extern size_t decodeBinaryLog(const vsg::Path& filename, vsg::Logger& logger, bool includeTimestamps = true);
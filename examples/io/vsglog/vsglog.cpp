@@ -2,6 +2,8 @@
 
 #include <iostream>
 
+#include "BinaryLog.h"
+
 class CustomLogger : public vsg::Inherit<vsg::Logger, CustomLogger>
 {
 public:
@@ -42,6 +44,7 @@ int main(int argc, char** argv)
 
     auto count = arguments.value<size_t>(0, "-n");
     auto level = vsg::Logger::Level(arguments.value(0, "-l"));
+    auto binaryFilename = arguments.value(vsg::Path(), "--binary");
 
     // you can override the message verbosity by setting the minimum level that will be printed.
     vsg::Logger::instance()->level = level;
@@ -120,6 +123,34 @@ int main(int argc, char** argv)
         auto time3 = std::chrono::duration<double, std::chrono::milliseconds::period>(tick5 - tick4).count();
         auto time4 = std::chrono::duration<double, std::chrono::milliseconds::period>(tick6 - tick5).count();
 
+        // binary logging defers all the formatting to the vsglogdecode tool
+        double time5 = 0.0, time6 = 0.0, time7 = 0.0;
+        if (binaryFilename)
+        {
+            auto binaryLogger = BinaryLogger::create(binaryFilename);
+
+            static const BinaryFormat s_simple(vsg::Logger::LOGGER_INFO, "simple");
+            static const BinaryFormat s_lineNumber(vsg::Logger::LOGGER_INFO, "line number {}");
+
+            auto tick7 = vsg::clock::now();
+            for(size_t i=0; i<count; ++i)
+            {
+                binaryLogger->log(s_simple);
+            }
+            auto tick8 = vsg::clock::now();
+            for(size_t i=0; i<count; ++i)
+            {
+                binaryLogger->log(s_lineNumber, i);
+            }
+            auto tick9 = vsg::clock::now();
+            binaryLogger->flush();
+            auto tick10 = vsg::clock::now();
+
+            time5 = std::chrono::duration<double, std::chrono::milliseconds::period>(tick8 - tick7).count();
+            time6 = std::chrono::duration<double, std::chrono::milliseconds::period>(tick9 - tick8).count();
+            time7 = std::chrono::duration<double, std::chrono::milliseconds::period>(tick10 - tick9).count();
+        }
+
         // To view the results will assign the StdLogger
         vsg::Logger::instance() = vsg::StdLogger::create();
         vsg::Logger::instance()->level = vsg::Logger::LOGGER_ALL;
@@ -128,6 +159,13 @@ int main(int argc, char** argv)
         vsg::info("vsg::info(\"line number i\" time = ",time2,"ms");
         vsg::info("null vsg::info(\"simple\") time = ",time3,"ms");
         vsg::info("null vsg::info(\"line number i\" time = ",time4,"ms");
+
+        if (binaryFilename)
+        {
+            vsg::info("binary log(\"simple\") time = ",time5,"ms");
+            vsg::info("binary log(\"line number {}\", i) time = ",time6,"ms");
+            vsg::info("binary flush time = ",time7,"ms, decode with: vsglogdecode ", binaryFilename);
+        }
     }
 
     return 0;
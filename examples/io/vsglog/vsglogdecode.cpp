@@ -0,0 +1,72 @@
+#include <vsg/all.h>
+
+#include <iostream>
+
+#include "BinaryLog.h"
+
+// example of a custom sink receiving the decoded messages, as with the CustomLogger in vsglog.
+class CustomLogger : public vsg::Inherit<vsg::Logger, CustomLogger>
+{
+public:
+    CustomLogger() {}
+
+protected:
+    void debug_implementation(const std::string_view& message) override
+    {
+        std::cout<<"custom debug : "<<message<<"\n";
+    }
+
+    void info_implementation(const std::string_view& message) override
+    {
+        std::cout<<"custom info : "<<message<<"\n";
+    }
+
+    void warn_implementation(const std::string_view& message) override
+    {
+        std::cout<<"custom warn : "<<message<<"\n";
+    }
+
+    void error_implementation(const std::string_view& message) override
+    {
+        std::cout<<"custom error : "<<message<<"\n";
+    }
+
+    void fatal_implementation(const std::string_view& message) override
+    {
+        // decoded fatal messages are reported rather than thrown so the rest of the log is still decoded.
+        std::cout<<"custom fatal : "<<message<<"\n";
+    }
+};
+
+int main(int argc, char** argv)
+{
+    vsg::CommandLine arguments(&argc, argv);
+
+    auto level = vsg::Logger::Level(arguments.value(0, "-l"));
+    auto useCustomLogger = arguments.read("--custom");
+    auto includeTimestamps = !arguments.read("--no-time");
+
+    if (arguments.errors()) return arguments.writeErrorMessages(std::cerr);
+
+    if (argc <= 1)
+    {
+        std::cout << "Usage: vsglogdecode file [--custom] [--no-time] [-l level]" << std::endl;
+        return 1;
+    }
+
+    vsg::ref_ptr<vsg::Logger> logger;
+    if (useCustomLogger)
+        logger = CustomLogger::create();
+    else
+        logger = vsg::StdLogger::create();
+
+    logger->level = level;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        auto numRecords = decodeBinaryLog(argv[i], *logger, includeTimestamps);
+        std::cerr << "Decoded " << numRecords << " records from " << argv[i] << std::endl;
+    }
+
+    return 0;
+}
@@ -0,0 +1,206 @@
+#include "RingBufferLogger.h"
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+namespace
+{
+    std::atomic<uint64_t> s_nextLoggerID{1};
+
+    size_t roundUpToPowerOfTwo(size_t size)
+    {
+        size_t result = 2;
+        while (result < size) result <<= 1;
+        return result;
+    }
+
+    int64_t timestamp()
+    {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(vsg::clock::now().time_since_epoch()).count();
+    }
+} // namespace
+
+RingBufferLogger::RingBufferLogger(Policy in_policy, size_t ringSize, std::ostream& output) :
+    policy(in_policy),
+    _id(s_nextLoggerID++),
+    _ringSize(roundUpToPowerOfTwo(ringSize)),
+    _output(output)
+{
+    _thread = std::thread([this]() { run(); });
+}
+
+RingBufferLogger::~RingBufferLogger()
+{
+    _running = false;
+    _flushCondition.notify_one();
+    if (_thread.joinable()) _thread.join();
+
+    writeRecords(true);
+}
+
+void RingBufferLogger::setThreadPrefix(std::thread::id id, const std::string& prefix)
+{
+    std::scoped_lock<std::mutex> lock(_ringsMutex);
+    _prefixes[id] = prefix;
+}
+
+RingBufferLogger::Ring* RingBufferLogger::threadRing()
+{
+    // each thread caches the rings it has been assigned so only the first message from a thread takes the rings lock.
+    thread_local std::vector<std::pair<uint64_t, Ring*>> s_rings;
+    for (auto& [id, ring] : s_rings)
+    {
+        if (id == _id) return ring;
+    }
+
+    std::scoped_lock<std::mutex> lock(_ringsMutex);
+    _rings.push_back(std::make_unique<Ring>(_ringSize, std::this_thread::get_id()));
+    s_rings.emplace_back(_id, _rings.back().get());
+    return _rings.back().get();
+}
+
+void RingBufferLogger::push(Level msgLevel, const std::string_view& message)
+{
+    auto ring = threadRing();
+
+    size_t head = ring->head.load(std::memory_order_relaxed);
+    size_t size = ring->records.size();
+    while (head - ring->tail.load(std::memory_order_acquire) >= size)
+    {
+        if (policy == DROP_WHEN_FULL || !_running)
+        {
+            ring->dropped.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+
+        _flushCondition.notify_one();
+        std::this_thread::yield();
+    }
+
+    auto& record = ring->records[head & ring->mask];
+    record.time = timestamp();
+    record.level = msgLevel;
+    record.length = static_cast<uint32_t>(std::min(message.size(), maxMessageLength));
+    std::memcpy(record.text, message.data(), record.length);
+
+    ring->head.store(head + 1, std::memory_order_release);
+
+    // wake the writer early once the ring is half full
+    if (head + 1 - ring->tail.load(std::memory_order_relaxed) == size / 2) _flushCondition.notify_one();
+}
+
+void RingBufferLogger::drain()
+{
+    writeRecords(true);
+}
+
+void RingBufferLogger::writeRecords(bool all)
+{
+    std::scoped_lock<std::mutex> writeLock(_writeMutex);
+
+    struct Cursor
+    {
+        Ring* ring;
+        std::string prefix;
+        size_t pos;
+        size_t end;
+    };
+
+    std::vector<Cursor> cursors;
+    {
+        std::scoped_lock<std::mutex> lock(_ringsMutex);
+        for (auto& ring : _rings)
+        {
+            auto itr = _prefixes.find(ring->threadId);
+            auto prefix = (itr != _prefixes.end()) ? itr->second : vsg::make_string("thread::id = ", ring->threadId, " | ");
+            cursors.push_back(Cursor{ring.get(), prefix, ring->tail.load(std::memory_order_relaxed), ring->head.load(std::memory_order_acquire)});
+        }
+    }
+
+    for (auto& cursor : cursors)
+    {
+        if (auto dropped = cursor.ring->dropped.exchange(0, std::memory_order_relaxed); dropped > 0)
+        {
+            _numDropped += dropped;
+            _output << cursor.prefix << "Warning: " << dropped << " log messages dropped.\n";
+        }
+    }
+
+    int64_t cutoff = all ? std::numeric_limits<int64_t>::max() : timestamp() - std::chrono::duration_cast<std::chrono::nanoseconds>(orderingWindow).count();
+
+    // merge the rings, each of which is already in timestamp order
+    size_t numWritten = 0;
+    for (;;)
+    {
+        Cursor* next = nullptr;
+        for (auto& cursor : cursors)
+        {
+            if (cursor.pos == cursor.end) continue;
+            if (!next || cursor.ring->records[cursor.pos & cursor.ring->mask].time < next->ring->records[next->pos & next->ring->mask].time) next = &cursor;
+        }
+        if (!next) break;
+
+        auto& record = next->ring->records[next->pos & next->ring->mask];
+        if (record.time > cutoff) break;
+
+        _output << next->prefix;
+        switch (record.level)
+        {
+        case (LOGGER_DEBUG): _output << "debug: "; break;
+        case (LOGGER_INFO): _output << "info: "; break;
+        case (LOGGER_WARN): _output << "Warning: "; break;
+        case (LOGGER_ERROR): _output << "ERROR: "; break;
+        case (LOGGER_FATAL): _output << "FATAL: "; break;
+        default: break;
+        }
+        _output.write(record.text, record.length);
+        _output << '\n';
+
+        // release the slot back to the writing thread
+        next->ring->tail.store(++next->pos, std::memory_order_release);
+        ++numWritten;
+    }
+
+    if (numWritten > 0) _output.flush();
+}
+
+void RingBufferLogger::run()
+{
+    while (_running)
+    {
+        {
+            std::unique_lock<std::mutex> lock(_flushMutex);
+            _flushCondition.wait_for(lock, flushInterval);
+        }
+
+        writeRecords(false);
+    }
+}
+
+void RingBufferLogger::debug_implementation(const std::string_view& message)
+{
+    push(LOGGER_DEBUG, message);
+}
+
+void RingBufferLogger::info_implementation(const std::string_view& message)
+{
+    push(LOGGER_INFO, message);
+}
+
+void RingBufferLogger::warn_implementation(const std::string_view& message)
+{
+    push(LOGGER_WARN, message);
+}
+
+void RingBufferLogger::error_implementation(const std::string_view& message)
+{
+    push(LOGGER_ERROR, message);
+}
+
+void RingBufferLogger::fatal_implementation(const std::string_view& message)
+{
+    push(LOGGER_FATAL, message);
+    drain();
+    throw vsg::Exception{std::string(message)};
+}
@@ -0,0 +1,110 @@
+#pragma once
+
+#include <vsg/all.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <thread>
+
+// RingBufferLogger is a vsg::Logger backend in which each thread appends its messages to its own single producer/single
+// consumer ring, with a background thread merging the records from all the rings and writing them out in timestamp order.
+// The calling thread never does any I/O or takes a lock shared with other logging threads, beyond the formatting lock held
+// by vsg::Logger's template methods, which can also be avoided by using RingBufferLogger::append(level, args...).
+class RingBufferLogger : public vsg::Inherit<vsg::Logger, RingBufferLogger>
+{
+public:
+    enum Policy
+    {
+        DROP_WHEN_FULL, // discard messages when a thread's ring is full, counting them so the number dropped is reported.
+        BLOCK_WHEN_FULL // wait for the writer thread to make space in the ring.
+    };
+
+    explicit RingBufferLogger(Policy in_policy = DROP_WHEN_FULL, size_t ringSize = 4096, std::ostream& output = std::cout);
+    ~RingBufferLogger();
+
+    const Policy policy;
+
+    // records are only written once they are older than orderingWindow so that records from a thread that was preempted
+    // just after taking its timestamp are still written in timestamp order.
+    std::chrono::microseconds orderingWindow{1000};
+    std::chrono::microseconds flushInterval{5000};
+
+    // long messages are truncated to fit in the fixed size records.
+    static constexpr size_t maxMessageLength = 232;
+
+    void setThreadPrefix(std::thread::id id, const std::string& prefix);
+
+    // format and append message without taking the vsg::Logger formatting lock.
+    template<typename... Args>
+    void append(Level msgLevel, Args&&... args)
+    {
+        if (level > msgLevel) return;
+
+        thread_local std::ostringstream s_stream;
+        s_stream.str({});
+        s_stream.clear();
+        (s_stream << ... << args);
+        push(msgLevel, s_stream.str());
+    }
+
+    // write all the records appended so far, blocking until they have been written.
+    void drain();
+
+    uint64_t numDropped() const { return _numDropped.load(); }
+
+protected:
+    struct Record
+    {
+        int64_t time;
+        Level level;
+        uint32_t length;
+        char text[maxMessageLength];
+    };
+
+    struct Ring
+    {
+        Ring(size_t size, std::thread::id id) :
+            records(size), mask(size - 1), threadId(id) {}
+
+        std::vector<Record> records;
+        const size_t mask;
+        const std::thread::id threadId;
+
+        // keep the producer and consumer indices on separate cache lines
+        alignas(64) std::atomic<size_t> head{0};
+        alignas(64) std::atomic<size_t> tail{0};
+        alignas(64) std::atomic<uint64_t> dropped{0};
+    };
+
+    Ring* threadRing();
+    void push(Level msgLevel, const std::string_view& message);
+    void writeRecords(bool all);
+    void run();
+
+    void debug_implementation(const std::string_view& message) override;
+    void info_implementation(const std::string_view& message) override;
+    void warn_implementation(const std::string_view& message) override;
+    void error_implementation(const std::string_view& message) override;
+    void fatal_implementation(const std::string_view& message) override;
+
+    const uint64_t _id;
+    const size_t _ringSize;
+    std::ostream& _output;
+
+    std::mutex _ringsMutex;
+    std::vector<std::unique_ptr<Ring>> _rings;
+    std::map<std::thread::id, std::string> _prefixes;
+
+    std::mutex _writeMutex;
+    std::atomic<uint64_t> _numDropped{0};
+
+    std::mutex _flushMutex;
+    std::condition_variable _flushCondition;
+    std::atomic_bool _running{true};
+    std::thread _thread;
+};
@@ -1,7 +1,10 @@
 #include <vsg/all.h>
 
+#include <algorithm>
 #include <iostream>
 
+#include "RingBufferLogger.h"
+
 struct MyOperation : public vsg::Inherit<vsg::Operation, MyOperation>
 {
     uint32_t value = 0;
@@ -15,20 +18,140 @@ struct MyOperation : public vsg::Inherit<vsg::Operation, MyOperation>
     }
 };
 
-int main(int argc, char** argv)
+struct BenchmarkResult
+{
+    double messagesPerSecond = 0.0;
+    double p50 = 0.0; // microseconds
+    double p99 = 0.0;
+    double max = 0.0;
+};
+
+// have numThreads threads each log count messages, timing every call
+template<typename F>
+BenchmarkResult benchmark(size_t numThreads, size_t count, F logMessage)
 {
-    // assign our custom ThreadLogger
-    auto mt_logger = vsg::ThreadLogger::create();
-    vsg::Logger::instance() = mt_logger;
+    std::vector<std::vector<double>> latencies(numThreads);
+    auto startLatch = vsg::Latch::create(1);
 
-    // set thread main thread prefix
-    mt_logger->setThreadPrefix(std::this_thread::get_id(), "main | ");
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < numThreads; ++t)
+    {
+        threads.emplace_back([&, t]() {
+            auto& threadLatencies = latencies[t];
+            threadLatencies.reserve(count);
+
+            startLatch->wait();
+
+            for (size_t i = 0; i < count; ++i)
+            {
+                auto before = vsg::clock::now();
+                logMessage(t, i);
+                threadLatencies.push_back(std::chrono::duration<double, std::chrono::microseconds::period>(vsg::clock::now() - before).count());
+            }
+        });
+    }
+
+    auto startTime = vsg::clock::now();
+    startLatch->count_down();
+    for (auto& thread : threads) thread.join();
+    auto time = std::chrono::duration<double>(vsg::clock::now() - startTime).count();
+
+    std::vector<double> all;
+    for (auto& threadLatencies : latencies) all.insert(all.end(), threadLatencies.begin(), threadLatencies.end());
+    std::sort(all.begin(), all.end());
+
+    BenchmarkResult result;
+    if (!all.empty())
+    {
+        result.messagesPerSecond = static_cast<double>(all.size()) / time;
+        result.p50 = all[all.size() / 2];
+        result.p99 = all[std::min(all.size() - 1, (all.size() * 99) / 100)];
+        result.max = all.back();
+    }
+    return result;
+}
+
+int runBenchmarks(size_t numThreads, size_t count)
+{
+    // logged messages go to std::cout so redirect it to a file or /dev/null, results are reported to std::cerr.
+    auto report = [](const std::string& name, const BenchmarkResult& result, double drainTime) {
+        std::cerr << name << " : " << result.messagesPerSecond << " messages/sec, call latency p50 = " << result.p50 << "us, p99 = " << result.p99 << "us, max = " << result.max << "us";
+        if (drainTime > 0.0) std::cerr << ", drain = " << drainTime << "ms";
+        std::cerr << std::endl;
+    };
+
+    auto logMessage = [](size_t t, size_t i) { vsg::info("benchmark thread ", t, " message ", i); };
+
+    {
+        vsg::Logger::instance() = vsg::ThreadLogger::create();
+        report("ThreadLogger", benchmark(numThreads, count, logMessage), 0.0);
+    }
+
+    for (auto policy : {RingBufferLogger::DROP_WHEN_FULL, RingBufferLogger::BLOCK_WHEN_FULL})
+    {
+        std::string policyName = (policy == RingBufferLogger::DROP_WHEN_FULL) ? "drop" : "block";
+
+        auto ring_logger = RingBufferLogger::create(policy);
+        vsg::Logger::instance() = ring_logger;
 
+        auto result = benchmark(numThreads, count, logMessage);
+
+        auto startDrain = vsg::clock::now();
+        ring_logger->drain();
+        auto drainTime = std::chrono::duration<double, std::chrono::milliseconds::period>(vsg::clock::now() - startDrain).count();
+
+        report("RingBufferLogger(" + policyName + ") vsg::info()", result, drainTime);
+        if (ring_logger->numDropped() > 0) std::cerr << "    dropped " << ring_logger->numDropped() << " messages" << std::endl;
+
+        // bypass the vsg::Logger formatting lock
+        result = benchmark(numThreads, count, [&](size_t t, size_t i) { ring_logger->append(vsg::Logger::LOGGER_INFO, "benchmark thread ", t, " message ", i); });
+
+        startDrain = vsg::clock::now();
+        ring_logger->drain();
+        drainTime = std::chrono::duration<double, std::chrono::milliseconds::period>(vsg::clock::now() - startDrain).count();
+
+        report("RingBufferLogger(" + policyName + ") append()", result, drainTime);
+        if (ring_logger->numDropped() > 0) std::cerr << "    dropped " << ring_logger->numDropped() << " messages in total" << std::endl;
+    }
+
+    vsg::Logger::instance() = vsg::StdLogger::create();
+
+    return 0;
+}
+
+int main(int argc, char** argv)
+{
     vsg::CommandLine arguments(&argc, argv);
     auto numThreads = arguments.value<size_t>(16, "-t");
     auto count = arguments.value<size_t>(100, "-n");
     auto level = vsg::Logger::Level(arguments.value(0, "-l"));
     auto defaultThreadPrefix = arguments.read({"-d", "--default"});
+    auto useRingBuffer = arguments.read("--ring");
+    auto blockWhenFull = arguments.read("--block");
+
+    if (arguments.read("--benchmark")) return runBenchmarks(numThreads, count);
+
+    // assign our custom ThreadLogger, or the RingBufferLogger that writes messages from a background thread.
+    vsg::ref_ptr<vsg::ThreadLogger> mt_logger;
+    vsg::ref_ptr<RingBufferLogger> ring_logger;
+    if (useRingBuffer)
+    {
+        ring_logger = RingBufferLogger::create(blockWhenFull ? RingBufferLogger::BLOCK_WHEN_FULL : RingBufferLogger::DROP_WHEN_FULL);
+        vsg::Logger::instance() = ring_logger;
+    }
+    else
+    {
+        mt_logger = vsg::ThreadLogger::create();
+        vsg::Logger::instance() = mt_logger;
+    }
+
+    auto setThreadPrefix = [&](std::thread::id id, const std::string& prefix) {
+        if (mt_logger) mt_logger->setThreadPrefix(id, prefix);
+        if (ring_logger) ring_logger->setThreadPrefix(id, prefix);
+    };
+
+    // set thread main thread prefix
+    setThreadPrefix(std::this_thread::get_id(), "main | ");
 
     // default to logger level 0 to print all messages, but allow command line to override.
     vsg::Logger::instance()->level = level;
@@ -41,7 +164,7 @@ int main(int argc, char** argv)
         for(auto& thread : operationThreads->threads)
         {
             auto prefix = vsg::make_string("thread ", threadNum++, " | ");
-            mt_logger->setThreadPrefix(thread.get_id(), prefix);
+            setThreadPrefix(thread.get_id(), prefix);
             vsg::info("set thread prefix for thread::id = ", thread.get_id(), " to ", prefix);
         }
     }
@@ -70,5 +193,7 @@ int main(int argc, char** argv)
 
     vsg::info("OperationThreads destroyed.");
 
+    if (ring_logger) ring_logger->drain();
+
     return 0;
 }
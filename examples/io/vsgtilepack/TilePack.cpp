@@ -0,0 +1,193 @@
+#include "TilePack.h"
+
+#include <algorithm>
+#include <cstring>
+#include <sstream>
+
+#if defined(__unix__) || defined(__APPLE__)
+#    include <fcntl.h>
+#    include <sys/mman.h>
+#    include <sys/stat.h>
+#    include <unistd.h>
+#    define TILEPACK_MMAP 1
+#endif
+
+namespace
+{
+    // read only streambuf over a block of memory, so tiles can be decoded from the mapping without copying them
+    class MemoryStreamBuf : public std::streambuf
+    {
+    public:
+        MemoryStreamBuf(const uint8_t* data, size_t size)
+        {
+            auto ptr = reinterpret_cast<char*>(const_cast<uint8_t*>(data));
+            setg(ptr, ptr, ptr + size);
+        }
+
+    protected:
+        pos_type seekoff(off_type off, std::ios_base::seekdir dir, std::ios_base::openmode) override
+        {
+            char* pos = (dir == std::ios_base::beg) ? eback() : ((dir == std::ios_base::cur) ? gptr() : egptr());
+            pos += off;
+            if (pos < eback() || pos > egptr()) return pos_type(off_type(-1));
+            setg(eback(), pos, egptr());
+            return pos_type(pos - eback());
+        }
+
+        pos_type seekpos(pos_type pos, std::ios_base::openmode mode) override
+        {
+            return seekoff(off_type(pos), std::ios_base::beg, mode);
+        }
+    };
+} // namespace
+
+TilePackWriter::TilePackWriter(const vsg::Path& in_filename, const TilePackHeader& in_header) :
+    filename(in_filename),
+    _header(in_header),
+    _fout(in_filename, std::ios::out | std::ios::binary)
+{
+    // header is rewritten on close() once the number of tiles and the index position are known
+    _fout.write(reinterpret_cast<const char*>(&_header), sizeof(TilePackHeader));
+    _offset = sizeof(TilePackHeader);
+}
+
+TilePackWriter::~TilePackWriter()
+{
+    if (_fout.is_open()) close();
+}
+
+bool TilePackWriter::add(uint32_t x, uint32_t y, uint32_t level, const void* data, size_t size)
+{
+    if (!_fout.good()) return false;
+
+    _fout.write(reinterpret_cast<const char*>(data), size);
+    _entries.push_back(TilePackEntry{tilePackKey(x, y, level), _offset, size});
+    _offset += size;
+
+    return _fout.good();
+}
+
+bool TilePackWriter::close()
+{
+    if (!_fout.is_open()) return false;
+
+    std::sort(_entries.begin(), _entries.end(), [](const TilePackEntry& lhs, const TilePackEntry& rhs) { return lhs.key < rhs.key; });
+
+    // pad so the index is 8 byte aligned and can be used in place from the mapping
+    const char padding[alignof(TilePackEntry)] = {};
+    auto numPadding = (alignof(TilePackEntry) - _offset % alignof(TilePackEntry)) % alignof(TilePackEntry);
+    _fout.write(padding, numPadding);
+    _offset += numPadding;
+
+    _header.numTiles = _entries.size();
+    _header.indexOffset = _offset;
+
+    _fout.write(reinterpret_cast<const char*>(_entries.data()), _entries.size() * sizeof(TilePackEntry));
+    _fout.seekp(0);
+    _fout.write(reinterpret_cast<const char*>(&_header), sizeof(TilePackHeader));
+
+    bool result = _fout.good();
+    _fout.close();
+    return result;
+}
+
+TilePackReader::TilePackReader(const vsg::Path& in_filename) :
+    filename(in_filename)
+{
+#if defined(TILEPACK_MMAP)
+    int fd = ::open(filename.string().c_str(), O_RDONLY);
+    if (fd < 0) return;
+
+    struct stat sb;
+    if (::fstat(fd, &sb) == 0 && sb.st_size > 0)
+    {
+        void* ptr = ::mmap(nullptr, static_cast<size_t>(sb.st_size), PROT_READ, MAP_SHARED, fd, 0);
+        if (ptr != MAP_FAILED)
+        {
+            _data = static_cast<const uint8_t*>(ptr);
+            _size = static_cast<size_t>(sb.st_size);
+        }
+    }
+    ::close(fd);
+#else
+    std::ifstream fin(filename, std::ios::in | std::ios::binary);
+    if (!fin) return;
+
+    fin.seekg(0, fin.end);
+    _buffer.resize(static_cast<size_t>(fin.tellg()));
+    fin.seekg(0);
+    fin.read(reinterpret_cast<char*>(_buffer.data()), _buffer.size());
+    if (!fin) return;
+
+    _data = _buffer.data();
+    _size = _buffer.size();
+#endif
+
+    if (_size < sizeof(TilePackHeader)) return;
+
+    auto header = reinterpret_cast<const TilePackHeader*>(_data);
+    if (std::memcmp(header->magic, TilePackHeader().magic, sizeof(header->magic)) != 0 || header->version != 1)
+    {
+        vsg::warn("TilePackReader: ", filename, " is not a tile pack.");
+        return;
+    }
+
+    if (header->indexOffset + header->numTiles * sizeof(TilePackEntry) > _size)
+    {
+        vsg::warn("TilePackReader: ", filename, " is truncated.");
+        return;
+    }
+
+    _header = header;
+    _entries = reinterpret_cast<const TilePackEntry*>(_data + header->indexOffset);
+}
+
+TilePackReader::~TilePackReader()
+{
+#if defined(TILEPACK_MMAP)
+    if (_data) ::munmap(const_cast<uint8_t*>(_data), _size);
+#endif
+}
+
+vsg::Path TilePackReader::tilePathTemplate() const
+{
+    return filename.string() + "/{z}/{x}/{y}" + (_header ? std::string(_header->extension) : std::string());
+}
+
+TilePackReader::Tile TilePackReader::find(uint32_t x, uint32_t y, uint32_t level) const
+{
+    if (!_header) return {};
+
+    uint64_t key = tilePackKey(x, y, level);
+    auto end = _entries + _header->numTiles;
+    auto itr = std::lower_bound(_entries, end, key, [](const TilePackEntry& entry, uint64_t value) { return entry.key < value; });
+    if (itr == end || itr->key != key) return {};
+
+    return Tile{_data + itr->offset, static_cast<size_t>(itr->size)};
+}
+
+vsg::ref_ptr<vsg::Object> TilePackReader::read(const vsg::Path& path, vsg::ref_ptr<const vsg::Options> options) const
+{
+    if (!_header) return {};
+
+    // only handle paths of the form <filename>/{z}/{x}/{y}<extension>
+    const auto& str = path.string();
+    const auto& prefix = filename.string();
+    if (str.size() <= prefix.size() + 1 || str.compare(0, prefix.size(), prefix) != 0 || (str[prefix.size()] != '/' && str[prefix.size()] != '\\')) return {};
+
+    uint32_t level = 0, x = 0, y = 0;
+    char separator1 = 0, separator2 = 0;
+    std::istringstream sstr(str.substr(prefix.size() + 1));
+    if (!(sstr >> level >> separator1 >> x >> separator2 >> y)) return {};
+
+    auto tile = find(x, y, level);
+    if (!tile.data) return {};
+
+    auto local_options = vsg::Options::create_if(options, *options);
+    if (!local_options) local_options = vsg::Options::create();
+    local_options->extensionHint = _header->extension;
+
+    MemoryStreamBuf buffer(tile.data, tile.size);
+    std::istream fin(&buffer);
+    return vsg::read(fin, local_options);
+}
@@ -0,0 +1,111 @@
+#pragma once
+
+#include <vsg/all.h>
+
+#include <fstream>
+
+// A tile pack holds a whole tile pyramid in a single file so that millions of small {z}/{x}/{y} tile files don't need to
+// be stored, copied and opened individually. The layout, written in the native (little endian) byte order, is:
+//
+//   TilePackHeader
+//   the original contents of each tile file, written in index order so tiles near each other are near each other in the file
+//   numTiles x TilePackEntry, sorted by key, for binary search
+//
+// The key interleaves the bits of x and y (a Morton/Z-order code) below the level, so the index and data are ordered
+// level by level and, within a level, spatially.
+
+struct TilePackHeader
+{
+    char magic[8] = {'V', 'S', 'G', 'T', 'P', 'A', 'C', 'K'};
+    uint32_t version = 1;
+    uint32_t noX = 0;
+    uint32_t noY = 0;
+    uint32_t maxLevel = 0;
+    uint64_t numTiles = 0;
+    uint64_t indexOffset = 0;
+    char extension[16] = {}; // file extension of the tiles, such as ".jpeg", used as the extensionHint when decoding
+};
+
+struct TilePackEntry
+{
+    uint64_t key;
+    uint64_t offset;
+    uint64_t size;
+};
+
+// key for tile x y level, supporting levels up to 28.
+inline uint64_t tilePackKey(uint32_t x, uint32_t y, uint32_t level)
+{
+    auto spread = [](uint64_t v) {
+        v &= 0x1fffffff;
+        v = (v | (v << 16)) & 0x0000ffff0000ffffull;
+        v = (v | (v << 8)) & 0x00ff00ff00ff00ffull;
+        v = (v | (v << 4)) & 0x0f0f0f0f0f0f0f0full;
+        v = (v | (v << 2)) & 0x3333333333333333ull;
+        v = (v | (v << 1)) & 0x5555555555555555ull;
+        return v;
+    };
+    return (static_cast<uint64_t>(level) << 58) | spread(x) | (spread(y) << 1);
+}
+
+// TilePackWriter streams tiles to the pack file as they are added and writes the index on close().
+class TilePackWriter : public vsg::Inherit<vsg::Object, TilePackWriter>
+{
+public:
+    TilePackWriter(const vsg::Path& in_filename, const TilePackHeader& in_header);
+
+    const vsg::Path filename;
+
+    bool valid() const { return _fout.good(); }
+
+    bool add(uint32_t x, uint32_t y, uint32_t level, const void* data, size_t size);
+    bool close();
+
+    size_t numTiles() const { return _entries.size(); }
+
+protected:
+    virtual ~TilePackWriter();
+
+    TilePackHeader _header;
+    std::ofstream _fout;
+    std::vector<TilePackEntry> _entries;
+    uint64_t _offset = 0;
+};
+
+// TilePackReader memory maps a pack file and serves the reads of tile paths of the form <pack filename>/{z}/{x}/{y}<extension>
+// from it, so it can be added to vsg::Options::readerWriters and used as a TileReader::imageLayer without any network or
+// per tile file access. Tile lookup is a binary search of the mapped index, the tile is then decoded straight from the mapping.
+class TilePackReader : public vsg::Inherit<vsg::ReaderWriter, TilePackReader>
+{
+public:
+    explicit TilePackReader(const vsg::Path& in_filename);
+
+    const vsg::Path filename;
+
+    bool valid() const { return _header != nullptr; }
+    const TilePackHeader& header() const { return *_header; }
+
+    // path template to use as TileReader::imageLayer or TileDatabaseSettings::imageLayer.
+    vsg::Path tilePathTemplate() const;
+
+    struct Tile
+    {
+        const uint8_t* data = nullptr;
+        size_t size = 0;
+    };
+
+    // find the raw, still encoded, contents of tile x y level, data is null if the tile isn't in the pack.
+    Tile find(uint32_t x, uint32_t y, uint32_t level) const;
+
+    vsg::ref_ptr<vsg::Object> read(const vsg::Path& path, vsg::ref_ptr<const vsg::Options> options = {}) const override;
+
+protected:
+    virtual ~TilePackReader();
+
+    const uint8_t* _data = nullptr;
+    size_t _size = 0;
+    std::vector<uint8_t> _buffer; // used in place of a mapping where mmap isn't available
+
+    const TilePackHeader* _header = nullptr;
+    const TilePackEntry* _entries = nullptr;
+};
@@ -0,0 +1,204 @@
+#include <vsg/all.h>
+
+#ifdef vsgXchange_FOUND
+#    include <vsgXchange/all.h>
+#endif
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <random>
+
+#include "TilePack.h"
+
+struct TileID
+{
+    uint32_t x;
+    uint32_t y;
+    uint32_t level;
+};
+
+vsg::Path getTilePath(const vsg::Path& src, uint32_t x, uint32_t y, uint32_t level)
+{
+    auto replace = [](std::string& path, const std::string& match, uint32_t value) {
+        auto pos = path.find(match);
+        if (pos != std::string::npos) path.replace(pos, match.length(), std::to_string(value));
+    };
+
+    std::string path = src.string();
+    replace(path, "{z}", level);
+    replace(path, "{x}", x);
+    replace(path, "{y}", y);
+    return path;
+}
+
+bool readFile(const vsg::Path& filename, std::vector<uint8_t>& buffer)
+{
+    std::ifstream fin(filename, std::ios::in | std::ios::binary | std::ios::ate);
+    if (!fin) return false;
+
+    buffer.resize(static_cast<size_t>(fin.tellg()));
+    fin.seekg(0);
+    fin.read(reinterpret_cast<char*>(buffer.data()), buffer.size());
+    return fin.good();
+}
+
+int main(int argc, char** argv)
+{
+    vsg::CommandLine arguments(&argc, argv);
+
+    auto options = vsg::Options::create();
+#ifdef vsgXchange_all
+    options->add(vsgXchange::all::create());
+#endif
+
+    // tile source with the same {z}/{x}/{y} path template as TileReader::imageLayer, i.e. a directory of tiles downloaded by vsgpagedlod --file-cache
+    auto sourceTemplate = arguments.value(vsg::Path(), "-i");
+    auto packFilename = arguments.value(vsg::Path("tiles.vsgtp"), "-o");
+    auto noX = arguments.value<uint32_t>(2, "--noX");
+    auto noY = arguments.value<uint32_t>(1, "--noY");
+    auto maxLevel = arguments.value<uint32_t>(10, "-m");
+    bool benchmark = arguments.read("--benchmark");
+    bool decode = arguments.read("--decode");
+
+    if (arguments.errors()) return arguments.writeErrorMessages(std::cerr);
+
+    if (!sourceTemplate)
+    {
+        std::cout << "Usage: vsgtilepack -i /data/tiles/{z}/{x}/{y}.jpeg [-o tiles.vsgtp] [--noX 2] [--noY 1] [-m maxLevel] [--benchmark] [--decode]" << std::endl;
+        return 1;
+    }
+
+    if (maxLevel > 28)
+    {
+        std::cout << "Tile packs support levels up to 28." << std::endl;
+        return 1;
+    }
+
+    TilePackHeader header;
+    header.noX = noX;
+    header.noY = noY;
+    header.maxLevel = maxLevel;
+    auto extension = vsg::fileExtension(sourceTemplate).string();
+    std::strncpy(header.extension, extension.c_str(), sizeof(header.extension) - 1);
+
+    auto writer = TilePackWriter::create(packFilename, header);
+    if (!writer->valid())
+    {
+        std::cout << "Unable to open " << packFilename << " for writing." << std::endl;
+        return 1;
+    }
+
+    // crawl the pyramid level by level, only descending below tiles that exist, and reading each level in key order
+    // so tiles that are close spatially end up close in the pack file.
+    std::vector<TileID> packed;
+    std::vector<TileID> level_tiles;
+    for (uint32_t y = 0; y < noY; ++y)
+    {
+        for (uint32_t x = 0; x < noX; ++x) level_tiles.push_back(TileID{x, y, 0});
+    }
+
+    uint64_t numBytes = 0;
+    std::vector<uint8_t> buffer;
+    auto startTime = vsg::clock::now();
+    for (uint32_t level = 0; level <= maxLevel && !level_tiles.empty(); ++level)
+    {
+        std::sort(level_tiles.begin(), level_tiles.end(), [](const TileID& lhs, const TileID& rhs) { return tilePackKey(lhs.x, lhs.y, lhs.level) < tilePackKey(rhs.x, rhs.y, rhs.level); });
+
+        std::vector<TileID> next_tiles;
+        uint32_t numLevelTiles = 0;
+        for (auto& tile : level_tiles)
+        {
+            if (!readFile(getTilePath(sourceTemplate, tile.x, tile.y, tile.level), buffer)) continue;
+
+            if (!writer->add(tile.x, tile.y, tile.level, buffer.data(), buffer.size()))
+            {
+                std::cout << "Failed writing to " << packFilename << std::endl;
+                return 1;
+            }
+
+            packed.push_back(tile);
+            numBytes += buffer.size();
+            ++numLevelTiles;
+
+            for (uint32_t dy = 0; dy < 2; ++dy)
+            {
+                for (uint32_t dx = 0; dx < 2; ++dx) next_tiles.push_back(TileID{tile.x * 2 + dx, tile.y * 2 + dy, level + 1});
+            }
+        }
+
+        std::cout << "    level " << level << " : " << numLevelTiles << " tiles" << std::endl;
+        level_tiles.swap(next_tiles);
+    }
+
+    if (!writer->close())
+    {
+        std::cout << "Failed writing to " << packFilename << std::endl;
+        return 1;
+    }
+
+    auto packTime = std::chrono::duration<double, std::chrono::milliseconds::period>(vsg::clock::now() - startTime).count();
+    std::cout << "Packed " << packed.size() << " tiles, " << (static_cast<double>(numBytes) / (1024.0 * 1024.0)) << "MB, into " << packFilename << " in " << packTime << "ms" << std::endl;
+
+    if (benchmark && !packed.empty())
+    {
+        auto reader = TilePackReader::create(packFilename);
+        if (!reader->valid()) return 1;
+
+        // visit the tiles in random order so neither path benefits from reading them in file order
+        std::vector<TileID> tiles(packed);
+        std::shuffle(tiles.begin(), tiles.end(), std::mt19937(1));
+
+        auto microseconds = [](vsg::time_point start) { return std::chrono::duration<double, std::chrono::microseconds::period>(vsg::clock::now() - start).count(); };
+
+        // sum the bytes so that the reads can't be optimized away and the pages of the mapping are touched
+        uint64_t checksum = 0;
+        auto start = vsg::clock::now();
+        for (auto& tile : tiles)
+        {
+            if (readFile(getTilePath(sourceTemplate, tile.x, tile.y, tile.level), buffer))
+            {
+                for (auto value : buffer) checksum += value;
+            }
+        }
+        double fileTime = microseconds(start);
+
+        uint64_t packChecksum = 0;
+        start = vsg::clock::now();
+        for (auto& tile : tiles)
+        {
+            auto data = reader->find(tile.x, tile.y, tile.level);
+            for (size_t i = 0; i < data.size; ++i) packChecksum += data.data[i];
+        }
+        double packReadTime = microseconds(start);
+
+        if (checksum != packChecksum) std::cout << "Warning: tile pack contents differ from the source tiles." << std::endl;
+
+        double numTiles = static_cast<double>(tiles.size());
+        std::cout << "Read benchmark, " << tiles.size() << " tiles in random order" << std::endl;
+        std::cout << "    tile files : " << (fileTime / numTiles) << " microseconds per tile" << std::endl;
+        std::cout << "    tile pack  : " << (packReadTime / numTiles) << " microseconds per tile" << std::endl;
+
+        if (decode)
+        {
+            // read and decode via the ReaderWriter, as TileReader does when the pack is used as its imageLayer
+            options->readerWriters.insert(options->readerWriters.begin(), reader);
+            auto pathTemplate = reader->tilePathTemplate();
+
+            uint32_t numFailed = 0;
+            start = vsg::clock::now();
+            for (auto& tile : tiles)
+            {
+                if (!vsg::read_cast<vsg::Data>(getTilePath(pathTemplate, tile.x, tile.y, tile.level), options)) ++numFailed;
+            }
+            double decodeTime = microseconds(start);
+
+            if (numFailed > 0) std::cout << "    Warning: " << numFailed << " tiles failed to decode." << std::endl;
+            std::cout << "    tile pack read and decode : " << (decodeTime / numTiles) << " microseconds per tile" << std::endl;
+        }
+    }
+
+    return 0;
+}
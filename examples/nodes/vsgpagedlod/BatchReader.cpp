@@ -0,0 +1,334 @@
+#include "BatchReader.h"
+#include "TileLoadStats.h"
+#include "TraceEvents.h"
+
+#include <fstream>
+#include <functional>
+#include <mutex>
+#include <set>
+
+#ifdef liburing_FOUND
+#    include <fcntl.h>
+#    include <liburing.h>
+#    include <sys/stat.h>
+#    include <unistd.h>
+#endif
+
+struct BatchReader::Request
+{
+    vsg::Path filename; // path as requested, used as the key in the returned PathObjects
+    vsg::Path filePath; // local file found for filename
+    std::vector<uint8_t> buffer;
+    int fd = -1;
+};
+
+struct BatchReader::Batch
+{
+    vsg::ref_ptr<const vsg::Options> options;
+    std::vector<Request> requests;
+    vsg::ref_ptr<vsg::Latch> latch;
+
+    std::mutex mutex;
+    vsg::PathObjects results;
+};
+
+namespace
+{
+    struct BatchOperation : public vsg::Inherit<vsg::Operation, BatchOperation>
+    {
+        explicit BatchOperation(std::function<void()> in_function) :
+            function(in_function) {}
+
+        std::function<void()> function;
+
+        void run() override { function(); }
+    };
+
+    bool readFile(const vsg::Path& filePath, std::vector<uint8_t>& buffer)
+    {
+        auto start = vsg::clock::now();
+
+        std::ifstream fin(filePath.c_str(), std::ios::in | std::ios::binary | std::ios::ate);
+        if (!fin) return false;
+
+        auto size = fin.tellg();
+        if (size <= 0) return false;
+
+        buffer.resize(static_cast<size_t>(size));
+        fin.seekg(0);
+        fin.read(reinterpret_cast<char*>(buffer.data()), size);
+
+        TileLoadStats::instance().add(TileLoadStats::FETCH, start, vsg::clock::now());
+        return fin.good();
+    }
+
+#ifdef liburing_FOUND
+    const unsigned queueDepth = 64;
+
+    // each thread reuses its own ring so there is no ring setup cost per batch.
+    struct Ring
+    {
+        io_uring ring;
+        bool valid = false;
+
+        Ring() { valid = io_uring_queue_init(queueDepth, &ring, 0) == 0; }
+        ~Ring()
+        {
+            if (valid) io_uring_queue_exit(&ring);
+        }
+    };
+#endif
+} // namespace
+
+BatchReader::BatchReader(uint32_t numThreads) :
+    backend(ioUringSupported() ? IO_URING : THREAD_POOL),
+    _threads(vsg::OperationThreads::create(numThreads))
+{
+}
+
+bool BatchReader::ioUringSupported()
+{
+#ifdef liburing_FOUND
+    // the kernel or container may not permit io_uring so check it can actually be used.
+    static bool s_supported = []() {
+        io_uring ring;
+        if (io_uring_queue_init(1, &ring, 0) != 0) return false;
+        io_uring_queue_exit(&ring);
+        return true;
+    }();
+    return s_supported;
+#else
+    return false;
+#endif
+}
+
+vsg::PathObjects BatchReader::read(const vsg::Paths& filenames, vsg::ref_ptr<const vsg::Options> options) const
+{
+    Batch batch;
+    batch.options = options;
+
+    vsg::Paths remaining;
+    for (auto& filename : filenames)
+    {
+        if (auto filePath = vsg::findFile(filename, options))
+            batch.requests.push_back(Request{filename, filePath, {}, -1});
+        else
+            remaining.push_back(filename);
+    }
+
+    if (!batch.requests.empty())
+    {
+        batch.latch = vsg::Latch::create(static_cast<int>(batch.requests.size()));
+
+        if (backend != IO_URING || !readWithIOUring(batch)) readWithThreadPool(batch);
+
+        batch.latch->wait();
+    }
+
+    // files that aren't local, such as http tiles, go through the standard read path
+    if (!remaining.empty())
+    {
+        for (auto& [filename, object] : vsg::read(remaining, options))
+        {
+            batch.results[filename] = object;
+        }
+    }
+
+    return batch.results;
+}
+
+void BatchReader::readWithThreadPool(Batch& batch) const
+{
+    for (auto& request : batch.requests)
+    {
+        auto requestPtr = &request;
+        _threads->add(BatchOperation::create([this, &batch, requestPtr]() {
+            readFile(requestPtr->filePath, requestPtr->buffer);
+            decode(batch, *requestPtr);
+        }));
+    }
+}
+
+bool BatchReader::readWithIOUring(Batch& batch) const
+{
+#ifdef liburing_FOUND
+    thread_local Ring s_ring;
+    if (!s_ring.valid) return false;
+
+    auto& ring = s_ring.ring;
+
+    auto readOnThreadPool = [&](Request& request) {
+        if (request.fd >= 0) ::close(request.fd);
+        request.fd = -1;
+
+        auto requestPtr = &request;
+        _threads->add(BatchOperation::create([this, &batch, requestPtr]() {
+            readFile(requestPtr->filePath, requestPtr->buffer);
+            decode(batch, *requestPtr);
+        }));
+    };
+
+    // stop using the ring after an error. The kernel may still be reading into the buffers of the requests in flight, so
+    // cancel those reads and wait for their completions before the thread pool reuses the buffers. If that isn't possible
+    // the ring is torn down and the buffers are deliberately leaked, as a late completion would otherwise write to freed memory.
+    auto abandonRing = [&](const std::vector<Request*>& inFlight, bool cancel) {
+        s_ring.valid = false;
+
+        std::set<Request*> pending(inFlight.begin(), inFlight.end());
+        if (cancel)
+        {
+            for (auto request : inFlight)
+            {
+                auto sqe = io_uring_get_sqe(&ring);
+                if (!sqe) break;
+                io_uring_prep_cancel(sqe, request, 0);
+                io_uring_sqe_set_data(sqe, nullptr);
+            }
+
+            if (io_uring_submit(&ring) >= 0)
+            {
+                while (!pending.empty())
+                {
+                    io_uring_cqe* cqe = nullptr;
+                    int result = io_uring_wait_cqe(&ring, &cqe);
+                    while (result == -EINTR) result = io_uring_wait_cqe(&ring, &cqe);
+                    if (result < 0 || !cqe) break;
+
+                    // the completions of the cancel requests themselves carry no Request
+                    pending.erase(static_cast<Request*>(io_uring_cqe_get_data(cqe)));
+                    io_uring_cqe_seen(&ring, cqe);
+                }
+            }
+        }
+
+        io_uring_queue_exit(&ring);
+
+        for (auto request : pending) new std::vector<uint8_t>(std::move(request->buffer));
+        for (auto request : inFlight) readOnThreadPool(*request);
+    };
+
+    size_t next = 0;
+    while (next < batch.requests.size())
+    {
+        // open and size each file, then submit all their reads with a single system call
+        std::vector<Request*> submitted;
+        for (; next < batch.requests.size() && submitted.size() < queueDepth; ++next)
+        {
+            auto& request = batch.requests[next];
+
+            struct stat fileStatus;
+            request.fd = ::open(request.filePath.c_str(), O_RDONLY);
+            if (request.fd < 0 || ::fstat(request.fd, &fileStatus) != 0 || fileStatus.st_size <= 0)
+            {
+                readOnThreadPool(request);
+                continue;
+            }
+
+            request.buffer.resize(static_cast<size_t>(fileStatus.st_size));
+
+            auto sqe = io_uring_get_sqe(&ring);
+            if (!sqe)
+            {
+                readOnThreadPool(request);
+                continue;
+            }
+
+            io_uring_prep_read(sqe, request.fd, request.buffer.data(), static_cast<unsigned>(request.buffer.size()), 0);
+            io_uring_sqe_set_data(sqe, &request);
+            submitted.push_back(&request);
+        }
+
+        if (submitted.empty()) continue;
+
+        // io_uring_submit() may consume only some of the entries so repeat until all the reads are in flight
+        auto submitTime = vsg::clock::now();
+        size_t numSubmitted = 0;
+        while (numSubmitted < submitted.size())
+        {
+            int result = io_uring_submit(&ring);
+            if (result == -EINTR) continue;
+            if (result <= 0)
+            {
+                // the entries not yet submitted never reached the kernel so only the submitted ones are in flight
+                vsg::warn("BatchReader::readWithIOUring() io_uring_submit() failed, falling back to thread pool.");
+                abandonRing(std::vector<Request*>(submitted.begin(), submitted.begin() + numSubmitted), false);
+                for (size_t i = numSubmitted; i < submitted.size(); ++i) readOnThreadPool(*submitted[i]);
+                for (; next < batch.requests.size(); ++next) readOnThreadPool(batch.requests[next]);
+                return true;
+            }
+            numSubmitted += static_cast<size_t>(result);
+        }
+
+        // hand each file to the decode threads as soon as its read completes, while the remaining reads are still in flight
+        for (size_t i = 0; i < submitted.size(); ++i)
+        {
+            io_uring_cqe* cqe = nullptr;
+            int result = io_uring_wait_cqe(&ring, &cqe);
+            while (result == -EINTR) result = io_uring_wait_cqe(&ring, &cqe);
+            if (result < 0 || !cqe)
+            {
+                // requests still holding an open file haven't completed so have the thread pool read them instead
+                vsg::warn("BatchReader::readWithIOUring() io_uring_wait_cqe() failed, result = ", result);
+                std::vector<Request*> inFlight;
+                for (auto request : submitted)
+                {
+                    if (request->fd >= 0) inFlight.push_back(request);
+                }
+                abandonRing(inFlight, true);
+                for (; next < batch.requests.size(); ++next) readOnThreadPool(batch.requests[next]);
+                return true;
+            }
+
+            auto request = static_cast<Request*>(io_uring_cqe_get_data(cqe));
+            int bytesRead = cqe->res;
+            io_uring_cqe_seen(&ring, cqe);
+
+            ::close(request->fd);
+            request->fd = -1;
+
+            TileLoadStats::instance().add(TileLoadStats::FETCH, submitTime, vsg::clock::now());
+
+            // on a failed or short read decode() will fall back to a regular read of the file
+            if (bytesRead != static_cast<int>(request->buffer.size())) request->buffer.clear();
+
+            _threads->add(BatchOperation::create([this, &batch, request]() {
+                decode(batch, *request);
+            }));
+        }
+    }
+
+    return true;
+#else
+    (void)batch;
+    return false;
+#endif
+}
+
+void BatchReader::decode(Batch& batch, Request& request) const
+{
+    TRACE_ZONE_CATEGORY(request.filename.string(), "read");
+
+    vsg::ref_ptr<vsg::Object> object;
+    if (!request.buffer.empty())
+    {
+        // decode from memory, using the extension hint to select the ReaderWriter
+        auto local_options = batch.options ? vsg::Options::create(*batch.options) : vsg::Options::create();
+        local_options->extensionHint = vsg::lowerCaseFileExtension(request.filename);
+
+        auto start = vsg::clock::now();
+        object = vsg::read(request.buffer.data(), request.buffer.size(), local_options);
+        if (object) TileLoadStats::instance().add(TileLoadStats::DECODE, start, vsg::clock::now());
+
+        std::vector<uint8_t>().swap(request.buffer);
+    }
+
+    // not all ReaderWriters support reading from memory so fallback to reading the file directly.
+    if (!object) object = vsg::read(request.filePath, batch.options);
+
+    {
+        std::scoped_lock<std::mutex> lock(batch.mutex);
+        batch.results[request.filename] = object;
+    }
+
+    batch.latch->count_down();
+}
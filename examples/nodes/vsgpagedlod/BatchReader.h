@@ -0,0 +1,36 @@
+#pragma once
+
+#include <vsg/all.h>
+
+// BatchReader reads a set of local files together, issuing all the file reads at once and handing each file to a decode
+// thread as soon as its data has arrived, so decoding of the first tiles overlaps with I/O of the rest.
+// On Linux builds with liburing the reads are submitted as a single io_uring batch, otherwise the thread pool performs the reads.
+// Paths that can't be found locally, such as http tiles, are passed on to vsg::read(paths, options).
+class BatchReader : public vsg::Inherit<vsg::Object, BatchReader>
+{
+public:
+    explicit BatchReader(uint32_t numThreads = 4);
+
+    enum Backend
+    {
+        THREAD_POOL,
+        IO_URING
+    };
+
+    // IO_URING if available in this build, can be set to THREAD_POOL to compare backends
+    Backend backend;
+
+    static bool ioUringSupported();
+
+    vsg::PathObjects read(const vsg::Paths& filenames, vsg::ref_ptr<const vsg::Options> options = {}) const;
+
+protected:
+    struct Request;
+    struct Batch;
+
+    void readWithThreadPool(Batch& batch) const;
+    bool readWithIOUring(Batch& batch) const;
+    void decode(Batch& batch, Request& request) const;
+
+    vsg::ref_ptr<vsg::OperationThreads> _threads;
+};
@@ -0,0 +1,432 @@
+#include "DiskTileCache.h"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+
+namespace
+{
+    const char* indexFilename = "tilecache.index";
+
+    // index file layout, in the native (little endian) byte order:
+    //
+    //   DiskTileCacheIndexHeader
+    //   numEntries x { uint32_t keySize, key, uint64_t size, uint32_t checksum, uint32_t accessCount, uint64_t lastAccess }
+    //   uint32_t CRC32 of all the preceding bytes
+    struct DiskTileCacheIndexHeader
+    {
+        char magic[8] = {'V', 'S', 'G', 'T', 'C', 'I', 'D', 'X'};
+        uint32_t version = 1;
+        uint32_t reserved = 0;
+        uint64_t numEntries = 0;
+        uint64_t clock = 0;
+    };
+
+    // CRC32 with the polynomial used by zlib and png.
+    uint32_t checksumCRC32(const uint8_t* data, size_t size)
+    {
+        static const auto table = []() {
+            std::array<uint32_t, 256> values;
+            for (uint32_t i = 0; i < 256; ++i)
+            {
+                uint32_t c = i;
+                for (int k = 0; k < 8; ++k) c = (c & 1) ? (0xedb88320u ^ (c >> 1)) : (c >> 1);
+                values[i] = c;
+            }
+            return values;
+        }();
+
+        uint32_t crc = 0xffffffffu;
+        for (size_t i = 0; i < size; ++i) crc = table[(crc ^ data[i]) & 0xff] ^ (crc >> 8);
+        return crc ^ 0xffffffffu;
+    }
+
+    std::filesystem::path fsPath(const vsg::Path& path)
+    {
+        return std::filesystem::path(path.native());
+    }
+
+    bool readFile(const std::filesystem::path& path, std::vector<uint8_t>& buffer)
+    {
+        std::ifstream fin(path, std::ios::in | std::ios::binary | std::ios::ate);
+        if (!fin) return false;
+
+        buffer.resize(static_cast<size_t>(fin.tellg()));
+        fin.seekg(0);
+        fin.read(reinterpret_cast<char*>(buffer.data()), buffer.size());
+        return fin.good();
+    }
+
+    template<typename T>
+    void append(std::vector<uint8_t>& buffer, const T& value)
+    {
+        auto ptr = reinterpret_cast<const uint8_t*>(&value);
+        buffer.insert(buffer.end(), ptr, ptr + sizeof(T));
+    }
+
+    // read a T from the buffer at position, returning false rather than reading beyond the end of the buffer.
+    template<typename T>
+    bool extract(const std::vector<uint8_t>& buffer, size_t end, size_t& position, T& value)
+    {
+        if (position + sizeof(T) > end) return false;
+        std::memcpy(&value, buffer.data() + position, sizeof(T));
+        position += sizeof(T);
+        return true;
+    }
+} // namespace
+
+DiskTileCache::DiskTileCache(const vsg::Path& in_directory, size_t in_maxBytes, Policy in_policy) :
+    directory(in_directory),
+    maxBytes(in_maxBytes),
+    policy(in_policy)
+{
+    std::error_code ec;
+    std::filesystem::create_directories(fsPath(directory), ec);
+
+    if (!load()) rebuild();
+}
+
+DiskTileCache::~DiskTileCache()
+{
+    save();
+}
+
+std::string DiskTileCache::cacheKey(const vsg::Path& filename) const
+{
+    const auto& str = filename.string();
+    for (auto& prefix : prefixes)
+    {
+        if (str.compare(0, prefix.size(), prefix) == 0)
+        {
+            auto pos = str.find("://");
+            return pos != std::string::npos ? str.substr(pos + 3) : str;
+        }
+    }
+    return {};
+}
+
+vsg::ref_ptr<vsg::Object> DiskTileCache::read(const vsg::Path& filename, vsg::ref_ptr<const vsg::Options> options) const
+{
+    auto key = cacheKey(filename);
+    if (key.empty()) return CompositeReaderWriter::read(filename, options);
+
+    auto path = directory / key;
+
+    // only one thread at a time reads, downloads or removes the file of a key, so a concurrent miss can't remove the file
+    // while another thread's download is writing it. Released however read() returns.
+    struct LoadingKey
+    {
+        const DiskTileCache* cache;
+        const std::string& key;
+        ~LoadingKey() { cache->finishedLoading(key); }
+    };
+
+    bool indexed = false;
+    Entry entry;
+    {
+        std::unique_lock<std::mutex> lock(_mutex);
+        _loadingCondition.wait(lock, [&]() { return _loading.count(key) == 0; });
+        _loading.insert(key);
+
+        if (auto itr = _entries.find(key); itr != _entries.end())
+        {
+            indexed = true;
+            entry = itr->second;
+        }
+    }
+
+    LoadingKey loadingKey{this, key};
+
+    auto local_options = vsg::Options::create_if(options, *options);
+    if (!local_options) local_options = vsg::Options::create();
+
+    if (indexed)
+    {
+        // read the whole file to check it against the index, then decode it from memory
+        std::vector<uint8_t> buffer;
+        if (readFile(fsPath(path), buffer) && buffer.size() == entry.size && checksumCRC32(buffer.data(), buffer.size()) == entry.checksum)
+        {
+            local_options->fileCache.clear();
+            local_options->extensionHint = vsg::lowerCaseFileExtension(filename);
+
+            auto object = CompositeReaderWriter::read(buffer.data(), buffer.size(), local_options);
+
+            // not all ReaderWriters support reading from memory so fallback to reading the file directly.
+            if (!object) object = CompositeReaderWriter::read(path, local_options);
+
+            if (object)
+            {
+                std::scoped_lock<std::mutex> lock(_mutex);
+                if (auto itr = _entries.find(key); itr != _entries.end())
+                {
+                    itr->second.lastAccess = ++_clock;
+                    ++itr->second.accessCount;
+                }
+                ++_stats.numHits;
+                _stats.bytesRead += buffer.size();
+                return object;
+            }
+        }
+
+        // missing, truncated, modified or undecodable
+        {
+            std::scoped_lock<std::mutex> lock(_mutex);
+            ++_stats.numCorrupt;
+        }
+        removeFile(key);
+    }
+
+    // a file that isn't in the index may not have been completely written, so remove it to make curl download it again
+    std::error_code ec;
+    std::filesystem::remove(fsPath(path), ec);
+
+    local_options->fileCache = directory;
+    local_options->extensionHint.clear();
+
+    auto object = CompositeReaderWriter::read(filename, local_options);
+    {
+        std::scoped_lock<std::mutex> lock(_mutex);
+        ++_stats.numMisses;
+    }
+
+    if (object) addFile(key);
+
+    return object;
+}
+
+void DiskTileCache::addFile(const std::string& key) const
+{
+    // index the file the wrapped ReaderWriters have written to the cache directory, if any
+    std::vector<uint8_t> buffer;
+    if (!readFile(fsPath(directory / key), buffer)) return;
+
+    std::vector<std::string> evicted;
+    {
+        std::scoped_lock<std::mutex> lock(_mutex);
+
+        auto& entry = _entries[key];
+        _totalBytes -= entry.size;
+
+        entry.size = buffer.size();
+        entry.checksum = checksumCRC32(buffer.data(), buffer.size());
+        entry.accessCount = 1;
+        entry.lastAccess = ++_clock;
+        _totalBytes += entry.size;
+
+        if (maxBytes > 0 && _totalBytes > maxBytes) evict(evicted);
+    }
+
+    // delete the files outside the lock so reads of other tiles aren't blocked
+    for (auto& evictedKey : evicted)
+    {
+        std::error_code ec;
+        std::filesystem::remove(fsPath(directory / evictedKey), ec);
+    }
+
+    changed();
+}
+
+void DiskTileCache::removeFile(const std::string& key) const
+{
+    {
+        std::scoped_lock<std::mutex> lock(_mutex);
+        if (auto itr = _entries.find(key); itr != _entries.end())
+        {
+            _totalBytes -= itr->second.size;
+            _entries.erase(itr);
+        }
+    }
+
+    std::error_code ec;
+    std::filesystem::remove(fsPath(directory / key), ec);
+
+    changed();
+}
+
+void DiskTileCache::finishedLoading(const std::string& key) const
+{
+    {
+        std::scoped_lock<std::mutex> lock(_mutex);
+        _loading.erase(key);
+    }
+    _loadingCondition.notify_all();
+}
+
+void DiskTileCache::evict(std::vector<std::string>& evicted) const
+{
+    // rank the files, least valuable first: LRU by last access, LFU by access count with ties broken by last access
+    using Rank = std::pair<uint64_t, uint64_t>;
+    std::vector<std::pair<Rank, std::map<std::string, Entry>::iterator>> ranked;
+    ranked.reserve(_entries.size());
+    for (auto itr = _entries.begin(); itr != _entries.end(); ++itr)
+    {
+        Rank rank = (policy == LFU) ? Rank(itr->second.accessCount, itr->second.lastAccess) : Rank(itr->second.lastAccess, 0);
+        ranked.emplace_back(rank, itr);
+    }
+    std::sort(ranked.begin(), ranked.end(), [](const auto& lhs, const auto& rhs) { return lhs.first < rhs.first; });
+
+    auto target = static_cast<uint64_t>(static_cast<double>(maxBytes) * lowWaterMark);
+    for (auto& [rank, itr] : ranked)
+    {
+        if (_totalBytes <= target) break;
+        // skip the files being read or downloaded, including the one just added
+        if (_loading.count(itr->first) != 0) continue;
+
+        _totalBytes -= itr->second.size;
+        ++_stats.numEvicted;
+        _stats.bytesEvicted += itr->second.size;
+        evicted.push_back(itr->first);
+        _entries.erase(itr);
+    }
+
+    // age the access counts so tiles that were popular in the past don't stay in the cache indefinitely
+    if (policy == LFU)
+    {
+        for (auto& [key, entry] : _entries) entry.accessCount /= 2;
+    }
+}
+
+void DiskTileCache::changed() const
+{
+    bool saveNow = false;
+    {
+        std::scoped_lock<std::mutex> lock(_mutex);
+        if (++_numChanges >= saveInterval)
+        {
+            _numChanges = 0;
+            saveNow = true;
+        }
+    }
+
+    if (saveNow) save();
+}
+
+bool DiskTileCache::save() const
+{
+    std::vector<uint8_t> buffer;
+    {
+        std::scoped_lock<std::mutex> lock(_mutex);
+
+        DiskTileCacheIndexHeader header;
+        header.numEntries = _entries.size();
+        header.clock = _clock;
+        append(buffer, header);
+
+        for (auto& [key, entry] : _entries)
+        {
+            append(buffer, static_cast<uint32_t>(key.size()));
+            buffer.insert(buffer.end(), key.begin(), key.end());
+            append(buffer, entry.size);
+            append(buffer, entry.checksum);
+            append(buffer, entry.accessCount);
+            append(buffer, entry.lastAccess);
+        }
+    }
+    append(buffer, checksumCRC32(buffer.data(), buffer.size()));
+
+    // write to a temporary file and rename it so an interrupted save leaves the previous index in place
+    std::scoped_lock<std::mutex> lock(_saveMutex);
+
+    auto indexPath = fsPath(directory / indexFilename);
+    auto tempPath = indexPath;
+    tempPath += ".tmp";
+    {
+        std::ofstream fout(tempPath, std::ios::out | std::ios::binary | std::ios::trunc);
+        fout.write(reinterpret_cast<const char*>(buffer.data()), buffer.size());
+        if (!fout.good()) return false;
+    }
+
+    std::error_code ec;
+    std::filesystem::rename(tempPath, indexPath, ec);
+    return !ec;
+}
+
+bool DiskTileCache::load()
+{
+    std::vector<uint8_t> buffer;
+    if (!readFile(fsPath(directory / indexFilename), buffer)) return false;
+
+    DiskTileCacheIndexHeader expected;
+    DiskTileCacheIndexHeader header;
+    uint32_t checksum = 0;
+    if (buffer.size() < sizeof(header) + sizeof(checksum)) return false;
+
+    size_t end = buffer.size() - sizeof(checksum);
+    std::memcpy(&checksum, buffer.data() + end, sizeof(checksum));
+    if (checksum != checksumCRC32(buffer.data(), end)) return false;
+
+    size_t position = 0;
+    extract(buffer, end, position, header);
+    if (std::memcmp(header.magic, expected.magic, sizeof(header.magic)) != 0 || header.version != expected.version) return false;
+
+    std::map<std::string, Entry> entries;
+    uint64_t totalBytes = 0;
+    for (uint64_t i = 0; i < header.numEntries; ++i)
+    {
+        uint32_t keySize = 0;
+        if (!extract(buffer, end, position, keySize) || position + keySize > end) return false;
+
+        std::string key(reinterpret_cast<const char*>(buffer.data() + position), keySize);
+        position += keySize;
+
+        Entry entry;
+        if (!extract(buffer, end, position, entry.size) || !extract(buffer, end, position, entry.checksum) ||
+            !extract(buffer, end, position, entry.accessCount) || !extract(buffer, end, position, entry.lastAccess)) return false;
+
+        totalBytes += entry.size;
+        entries[key] = entry;
+    }
+
+    std::scoped_lock<std::mutex> lock(_mutex);
+    _entries.swap(entries);
+    _totalBytes = totalBytes;
+    _clock = header.clock;
+    return true;
+}
+
+void DiskTileCache::rebuild()
+{
+    // index the files already in the cache directory, the order they were used in is unknown so they start out equal
+    std::map<std::string, Entry> entries;
+    uint64_t totalBytes = 0;
+
+    auto root = fsPath(directory);
+    std::error_code ec;
+    std::vector<uint8_t> buffer;
+    for (auto itr = std::filesystem::recursive_directory_iterator(root, ec); !ec && itr != std::filesystem::recursive_directory_iterator(); itr.increment(ec))
+    {
+        if (!itr->is_regular_file(ec)) continue;
+
+        auto key = itr->path().lexically_relative(root).generic_string();
+        // skip the index and any temporary files left by an interrupted write
+        if (key == indexFilename || key.find(".tmp") != std::string::npos) continue;
+
+        if (!readFile(itr->path(), buffer)) continue;
+
+        Entry entry;
+        entry.size = buffer.size();
+        entry.checksum = checksumCRC32(buffer.data(), buffer.size());
+        totalBytes += entry.size;
+        entries[key] = entry;
+    }
+
+    {
+        std::scoped_lock<std::mutex> lock(_mutex);
+        _entries.swap(entries);
+        _totalBytes = totalBytes;
+    }
+
+    save();
+}
+
+DiskTileCache::Stats DiskTileCache::stats() const
+{
+    std::scoped_lock<std::mutex> lock(_mutex);
+
+    Stats stats = _stats;
+    stats.numFiles = _entries.size();
+    stats.totalBytes = _totalBytes;
+    return stats;
+}
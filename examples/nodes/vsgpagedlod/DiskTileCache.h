@@ -0,0 +1,91 @@
+#pragma once
+
+#include <vsg/all.h>
+
+#include <condition_variable>
+#include <map>
+#include <mutex>
+#include <set>
+
+// DiskTileCache manages the options->fileCache directory that vsgXchange's curl ReaderWriter writes downloaded tiles to, which
+// otherwise grows without limit. It wraps the ReaderWriters that would otherwise be assigned to the Options and serves the
+// reads of remote tiles from the cache directory itself, checking each file's size and CRC32 against the index before
+// decoding it. On a miss the read is passed on to the wrapped ReaderWriters with the fileCache set so the downloaded file is
+// written to the cache directory, then the file is added to the index. Once the files exceed maxBytes the least recently
+// used, or least frequently used, are deleted until the cache is back under lowWaterMark of maxBytes.
+//
+// The index is saved to tilecache.index in the cache directory so startup doesn't need to scan and checksum the cache, if it's
+// missing or corrupt the directory is scanned to rebuild it. Files in the cache directory that aren't in the index, such as
+// those written after the index was last saved, may be incomplete so are downloaded again. Concurrent reads of the same
+// file wait for each other, so a file is only downloaded once and a partially written file is never removed.
+class DiskTileCache : public vsg::Inherit<vsg::CompositeReaderWriter, DiskTileCache>
+{
+public:
+    enum Policy
+    {
+        LRU,
+        LFU
+    };
+
+    DiskTileCache(const vsg::Path& in_directory, size_t in_maxBytes, Policy in_policy = LRU);
+
+    const vsg::Path directory;
+    const size_t maxBytes;
+    const Policy policy;
+    double lowWaterMark = 0.9;   // proportion of maxBytes to evict down to, so files aren't evicted on every miss
+    uint32_t saveInterval = 256; // number of files added or removed between saves of the index
+
+    // filenames starting with one of the prefixes are cached, with any <protocol>:// removed to give the path in the cache directory.
+    std::vector<std::string> prefixes = {"http://", "https://"};
+
+    vsg::ref_ptr<vsg::Object> read(const vsg::Path& filename, vsg::ref_ptr<const vsg::Options> options = {}) const override;
+    using CompositeReaderWriter::read;
+
+    // write the index, called automatically every saveInterval changes and on destruction.
+    bool save() const;
+
+    struct Stats
+    {
+        uint64_t numHits = 0;
+        uint64_t numMisses = 0;
+        uint64_t numCorrupt = 0; // cached files that failed the integrity check so were deleted and downloaded again
+        uint64_t numEvicted = 0;
+        uint64_t bytesRead = 0; // bytes of the files served from the cache
+        uint64_t bytesEvicted = 0;
+        size_t numFiles = 0;
+        uint64_t totalBytes = 0;
+    };
+
+    Stats stats() const;
+
+protected:
+    virtual ~DiskTileCache();
+
+    struct Entry
+    {
+        uint64_t size = 0;
+        uint32_t checksum = 0;
+        uint32_t accessCount = 0;
+        uint64_t lastAccess = 0; // value of _clock when last read
+    };
+
+    std::string cacheKey(const vsg::Path& filename) const;
+    bool load();
+    void rebuild();
+    void addFile(const std::string& key) const;
+    void removeFile(const std::string& key) const;
+    void finishedLoading(const std::string& key) const;
+    void evict(std::vector<std::string>& evicted) const;
+    void changed() const;
+
+    mutable std::mutex _mutex;
+    mutable std::map<std::string, Entry> _entries;
+    mutable uint64_t _clock = 0;
+    mutable uint64_t _totalBytes = 0;
+    mutable uint32_t _numChanges = 0;
+    mutable Stats _stats;
+    mutable std::set<std::string> _loading; // keys whose files are being read or downloaded
+    mutable std::condition_variable _loadingCondition;
+
+    mutable std::mutex _saveMutex;
+};
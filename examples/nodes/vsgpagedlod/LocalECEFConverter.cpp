@@ -0,0 +1,96 @@
+#include "LocalECEFConverter.h"
+
+#include <algorithm>
+
+LocalECEFConverter::LocalECEFConverter(const vsg::EllipsoidModel& ellipsoidModel, const vsg::dmat4& in_worldToLocal) :
+    _radiusEquator(ellipsoidModel.radiusEquator()),
+    _worldToLocal(in_worldToLocal)
+{
+    double radiusPolar = ellipsoidModel.radiusPolar();
+    _eccentricitySquared = (_radiusEquator * _radiusEquator - radiusPolar * radiusPolar) / (_radiusEquator * _radiusEquator);
+}
+
+void LocalECEFConverter::convert(const vsg::dvec3* latitudeLongitudeAltitude, vsg::vec3* local, size_t count) const
+{
+    constexpr size_t blockSize = 256;
+    double sinLatitude[blockSize];
+    double cosLatitude[blockSize];
+    double sinLongitude[blockSize];
+    double cosLongitude[blockSize];
+
+    const auto& m = _worldToLocal;
+    const double a = _radiusEquator;
+    const double e2 = _eccentricitySquared;
+
+    for (size_t start = 0; start < count; start += blockSize)
+    {
+        size_t n = std::min(blockSize, count - start);
+        const vsg::dvec3* lla = latitudeLongitudeAltitude + start;
+        vsg::vec3* output = local + start;
+
+        for (size_t i = 0; i < n; ++i)
+        {
+            double latitude = vsg::radians(lla[i].x);
+            double longitude = vsg::radians(lla[i].y);
+            sinLatitude[i] = std::sin(latitude);
+            cosLatitude[i] = std::cos(latitude);
+            sinLongitude[i] = std::sin(longitude);
+            cosLongitude[i] = std::cos(longitude);
+        }
+
+        for (size_t i = 0; i < n; ++i)
+        {
+            double altitude = lla[i].z;
+            double N = a / std::sqrt(1.0 - e2 * sinLatitude[i] * sinLatitude[i]);
+            double x = (N + altitude) * cosLatitude[i] * cosLongitude[i];
+            double y = (N + altitude) * cosLatitude[i] * sinLongitude[i];
+            double z = (N * (1.0 - e2) + altitude) * sinLatitude[i];
+
+            output[i].set(static_cast<float>(m[0][0] * x + m[1][0] * y + m[2][0] * z + m[3][0]),
+                          static_cast<float>(m[0][1] * x + m[1][1] * y + m[2][1] * z + m[3][1]),
+                          static_cast<float>(m[0][2] * x + m[1][2] * y + m[2][2] * z + m[3][2]));
+        }
+    }
+}
+
+void LocalECEFConverter::convertGrid(const double* latitudes, uint32_t numRows, const double* longitudes, uint32_t numCols, double altitude, vsg::vec3* local) const
+{
+    std::vector<double> sinLongitude(numCols);
+    std::vector<double> cosLongitude(numCols);
+    for (uint32_t c = 0; c < numCols; ++c)
+    {
+        double longitude = vsg::radians(longitudes[c]);
+        sinLongitude[c] = std::sin(longitude);
+        cosLongitude[c] = std::cos(longitude);
+    }
+
+    const auto& m = _worldToLocal;
+    const double a = _radiusEquator;
+    const double e2 = _eccentricitySquared;
+
+    for (uint32_t r = 0; r < numRows; ++r)
+    {
+        double latitude = vsg::radians(latitudes[r]);
+        double sinLatitude = std::sin(latitude);
+        double cosLatitude = std::cos(latitude);
+        double N = a / std::sqrt(1.0 - e2 * sinLatitude * sinLatitude);
+        double radius = (N + altitude) * cosLatitude;
+        double z = (N * (1.0 - e2) + altitude) * sinLatitude;
+
+        // the z and translation contributions are the same for the whole row
+        double rowX = m[2][0] * z + m[3][0];
+        double rowY = m[2][1] * z + m[3][1];
+        double rowZ = m[2][2] * z + m[3][2];
+
+        vsg::vec3* output = local + static_cast<size_t>(r) * numCols;
+        for (uint32_t c = 0; c < numCols; ++c)
+        {
+            double x = radius * cosLongitude[c];
+            double y = radius * sinLongitude[c];
+
+            output[c].set(static_cast<float>(m[0][0] * x + m[1][0] * y + rowX),
+                          static_cast<float>(m[0][1] * x + m[1][1] * y + rowY),
+                          static_cast<float>(m[0][2] * x + m[1][2] * y + rowZ));
+        }
+    }
+}
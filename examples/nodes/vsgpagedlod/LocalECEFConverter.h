@@ -0,0 +1,25 @@
+#pragma once
+
+#include <vsg/all.h>
+
+// LocalECEFConverter converts latitude, longitude, altitude coordinates to ECEF and then into a tile's local coordinate
+// frame, batching the work over whole arrays rather than calling EllipsoidModel::convertLatLongAltitudeToECEF() and a
+// dmat4 multiply per vertex. The trig is done in a separate pass from the arithmetic so the latter is a straight
+// run of multiply/adds and sqrt over plain arrays that the compiler can vectorize.
+class LocalECEFConverter
+{
+public:
+    LocalECEFConverter(const vsg::EllipsoidModel& ellipsoidModel, const vsg::dmat4& in_worldToLocal);
+
+    // convert count latitude, longitude, altitude coordinates (degrees, degrees, metres) to local coordinates.
+    void convert(const vsg::dvec3* latitudeLongitudeAltitude, vsg::vec3* local, size_t count) const;
+
+    // convert a regular grid of numRows x numCols coordinates, latitude varying by row and longitude by column, writing
+    // to local in row order. The trig only needs computing once per row and column rather than once per vertex.
+    void convertGrid(const double* latitudes, uint32_t numRows, const double* longitudes, uint32_t numCols, double altitude, vsg::vec3* local) const;
+
+protected:
+    double _radiusEquator;
+    double _eccentricitySquared;
+    vsg::dmat4 _worldToLocal;
+};
@@ -0,0 +1,82 @@
+#include "ParallelLoadPagedLOD.h"
+#include "TileLoadStats.h"
+
+#include <algorithm>
+#include <thread>
+
+namespace
+{
+    // collect the PagedLOD in a subgraph without traversing into them, the next level of PagedLOD is collected from
+    // their high resolution children once they are loaded.
+    class CollectPagedLOD : public vsg::Inherit<vsg::Visitor, CollectPagedLOD>
+    {
+    public:
+        std::vector<vsg::ref_ptr<vsg::PagedLOD>> plods;
+
+        void apply(vsg::Object& object) override
+        {
+            object.traverse(*this);
+        }
+
+        void apply(vsg::PagedLOD& plod) override
+        {
+            plods.push_back(vsg::ref_ptr<vsg::PagedLOD>(&plod));
+        }
+    };
+} // namespace
+
+ParallelLoadPagedLOD::ParallelLoadPagedLOD(int in_loadLevels, uint32_t in_numThreads) :
+    loadLevels(in_loadLevels),
+    numThreads(std::max(in_numThreads, 1u))
+{
+}
+
+bool ParallelLoadPagedLOD::limitReached() const
+{
+    return (maxNumTiles > 0 && numTiles >= maxNumTiles) || (maxBytes > 0 && numBytes >= maxBytes);
+}
+
+void ParallelLoadPagedLOD::load(vsg::Node& node)
+{
+    auto collect = CollectPagedLOD::create();
+    node.accept(*collect);
+    auto plods = std::move(collect->plods);
+
+    for (int level = 0; level < loadLevels && !plods.empty() && !limitReached(); ++level)
+    {
+        uint32_t numTilesBefore = numTiles;
+
+        // each thread takes the next PagedLOD of the level to read, the reads of different PagedLOD don't share any state
+        // so the loaded children can be assigned directly.
+        std::atomic<size_t> next{0};
+        auto readTiles = [&]() {
+            for (size_t i = next++; i < plods.size() && !limitReached(); i = next++)
+            {
+                auto& plod = plods[i];
+                if (plod->children[0].node || plod->filename.empty()) continue;
+
+                if (auto subgraph = vsg::read_cast<vsg::Node>(plod->filename, plod->options))
+                {
+                    if (auto tileGroup = subgraph.cast<TileGroup>()) numBytes += tileGroup->cpuBytes + tileGroup->gpuBytes;
+                    plod->children[0].node = subgraph;
+                    ++numTiles;
+                }
+            }
+        };
+
+        std::vector<std::thread> threads;
+        for (uint32_t i = 1; i < numThreads; ++i) threads.emplace_back(readTiles);
+        readTiles();
+        for (auto& thread : threads) thread.join();
+
+        numTilesPerLevel.push_back(numTiles - numTilesBefore);
+
+        // only the frontier of PagedLOD is held between levels, the loaded tiles are held by the scene graph
+        collect->plods.clear();
+        for (auto& plod : plods)
+        {
+            if (plod->children[0].node) plod->children[0].node->accept(*collect);
+        }
+        plods = std::move(collect->plods);
+    }
+}
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <vsg/all.h>
+
+#include <atomic>
+
+// ParallelLoadPagedLOD preloads the first loadLevels levels of PagedLOD like vsg::LoadPagedLOD, but rather than reading one
+// tile at a time during a depth first traversal it discovers the PagedLOD breadth first and reads each level's high
+// resolution children across numThreads threads. Reading level by level loads the coarse levels completely before any
+// of the finer ones, so when the maxNumTiles or maxBytes limits stop the preload the tiles loaded still cover the
+// whole database.
+class ParallelLoadPagedLOD : public vsg::Inherit<vsg::Object, ParallelLoadPagedLOD>
+{
+public:
+    ParallelLoadPagedLOD(int in_loadLevels, uint32_t in_numThreads);
+
+    int loadLevels = 0;
+    uint32_t numThreads = 1;
+    uint32_t maxNumTiles = 0; // 0 for no limit
+    size_t maxBytes = 0;      // limit on the CPU and GPU bytes of the loaded subtiles, requires TileReader::memoryBudget, 0 for no limit
+
+    void load(vsg::Node& node);
+
+    std::atomic<uint32_t> numTiles{0};
+    std::atomic<size_t> numBytes{0};
+    std::vector<uint32_t> numTilesPerLevel;
+
+protected:
+    bool limitReached() const;
+};
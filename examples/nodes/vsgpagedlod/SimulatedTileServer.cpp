@@ -0,0 +1,169 @@
+#include "SimulatedTileServer.h"
+#include "TileLoadStats.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <thread>
+
+namespace
+{
+    const std::string prefix("simulated_tiles");
+}
+
+SimulatedTileServer::SimulatedTileServer() :
+    _random(1),
+    _bandwidthAvailable(vsg::clock::now())
+{
+}
+
+vsg::Path SimulatedTileServer::tilePathTemplate() const
+{
+    return prefix + "/{z}/{x}/{y}" + (source ? std::string(source->header().extension) : std::string());
+}
+
+vsg::ref_ptr<vsg::Object> SimulatedTileServer::read(const vsg::Path& path, vsg::ref_ptr<const vsg::Options> options) const
+{
+    // only handle paths of the form simulated_tiles/{z}/{x}/{y}<extension>
+    const auto& str = path.string();
+    if (str.size() <= prefix.size() + 1 || str.compare(0, prefix.size(), prefix) != 0 || str[prefix.size()] != '/') return {};
+
+    uint32_t level = 0, x = 0, y = 0;
+    char separator1 = 0, separator2 = 0;
+    std::istringstream sstr(str.substr(prefix.size() + 1));
+    if (!(sstr >> level >> separator1 >> x >> separator2 >> y)) return {};
+
+    // like vsgXchange's curl ReaderWriter, serve tiles already downloaded to the fileCache from there
+    vsg::Path cachePath;
+    if (options && options->fileCache) cachePath = options->fileCache / path;
+    if (cachePath && vsg::fileExists(cachePath))
+    {
+        auto local_options = vsg::Options::create(*options);
+        local_options->fileCache.clear();
+        if (auto object = vsg::read(cachePath, local_options)) return object;
+    }
+
+    auto start = vsg::clock::now();
+
+    TilePackReader::Tile tile;
+    size_t size = generatedTileBytes;
+    if (source)
+    {
+        tile = source->find(x, y, level);
+        size = tile.data ? tile.size : 0;
+    }
+
+    // schedule the request, transfers share the connection so are queued behind those already in flight
+    bool failed = false;
+    vsg::time_point completed;
+    {
+        std::scoped_lock<std::mutex> lock(_mutex);
+
+        failed = (size == 0) || std::uniform_real_distribution<double>(0.0, 1.0)(_random) < errorRate;
+        double delay = std::max(0.0, latency + std::uniform_real_distribution<double>(-latencyJitter, latencyJitter)(_random));
+
+        completed = start + std::chrono::duration_cast<vsg::clock::duration>(std::chrono::duration<double>(delay));
+        if (!failed && bandwidth > 0.0)
+        {
+            auto transfer = std::chrono::duration_cast<vsg::clock::duration>(std::chrono::duration<double>(static_cast<double>(size) / bandwidth));
+            completed = std::max(completed, _bandwidthAvailable) + transfer;
+            _bandwidthAvailable = completed;
+        }
+    }
+
+    // wait in short steps so the request can be abandoned if the tile load is cancelled, as a real request would be aborted
+    auto token = options ? options->getObject<CancellationToken>("CancellationToken") : nullptr;
+    while (vsg::clock::now() < completed)
+    {
+        if (token && token->cancelled())
+        {
+            std::scoped_lock<std::mutex> lock(_mutex);
+            ++_stats.numRequests;
+            ++_stats.numCancelled;
+            return {};
+        }
+        std::this_thread::sleep_until(std::min(completed, vsg::clock::now() + std::chrono::milliseconds(5)));
+    }
+
+    vsg::ref_ptr<vsg::Object> object;
+    if (!failed)
+    {
+        auto start_decode = vsg::clock::now();
+        TileLoadStats::instance().add(TileLoadStats::FETCH, start, start_decode);
+
+        if (source)
+            object = source->read(vsg::make_string(source->filename, "/", level, "/", x, "/", y, source->header().extension), options);
+        else
+            object = generateTile(x, y, level);
+
+        TileLoadStats::instance().add(TileLoadStats::DECODE, start_decode, vsg::clock::now());
+
+        // write the downloaded file to the fileCache, generated tiles have no file to cache. The file is written under a temporary
+        // name and renamed so a concurrent read never sees a partially written file.
+        if (object && cachePath && tile.data)
+        {
+            vsg::makeDirectory(vsg::filePath(cachePath));
+
+            auto tempPath = vsg::make_string(cachePath.string(), ".tmp", std::this_thread::get_id());
+            {
+                std::ofstream fout(tempPath, std::ios::out | std::ios::binary);
+                fout.write(reinterpret_cast<const char*>(tile.data), tile.size);
+            }
+            std::rename(tempPath.c_str(), cachePath.string().c_str());
+        }
+    }
+
+    double time = std::chrono::duration<double, std::chrono::milliseconds::period>(vsg::clock::now() - start).count();
+
+    std::scoped_lock<std::mutex> lock(_mutex);
+    ++_stats.numRequests;
+    if (object)
+    {
+        _stats.bytesTransferred += size;
+        _stats.latencies.push_back(time);
+    }
+    else
+    {
+        ++_stats.numFailed;
+    }
+
+    return object;
+}
+
+SimulatedTileServer::Stats SimulatedTileServer::stats() const
+{
+    std::scoped_lock<std::mutex> lock(_mutex);
+    return _stats;
+}
+
+vsg::ref_ptr<vsg::Data> SimulatedTileServer::generateTile(uint32_t x, uint32_t y, uint32_t level) const
+{
+    static const vsg::ubvec4 levelColors[] = {
+        {230, 25, 75, 255}, {60, 180, 75, 255}, {255, 225, 25, 255}, {0, 130, 200, 255},
+        {245, 130, 48, 255}, {145, 30, 180, 255}, {70, 240, 240, 255}, {240, 50, 230, 255}};
+
+    auto color = levelColors[level % 8];
+    if ((x + y) % 2 == 1) color = vsg::ubvec4(color.r * 3 / 4, color.g * 3 / 4, color.b * 3 / 4, 255);
+    const vsg::ubvec4 border(32, 32, 32, 255);
+
+    auto image = vsg::ubvec4Array2D::create(tileSize, tileSize, vsg::Data::Properties{VK_FORMAT_R8G8B8A8_UNORM});
+    for (uint32_t r = 0; r < tileSize; ++r)
+    {
+        for (uint32_t c = 0; c < tileSize; ++c)
+        {
+            bool edge = r < 2 || c < 2 || r + 2 >= tileSize || c + 2 >= tileSize;
+            image->set(c, r, edge ? border : color);
+        }
+    }
+    return image;
+}
+
+double percentile(std::vector<double> values, double p)
+{
+    if (values.empty()) return 0.0;
+
+    auto index = std::min(values.size() - 1, static_cast<size_t>(p / 100.0 * static_cast<double>(values.size())));
+    std::nth_element(values.begin(), values.begin() + index, values.end());
+    return values[index];
+}
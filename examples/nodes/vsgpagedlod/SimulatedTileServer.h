@@ -0,0 +1,57 @@
+#pragma once
+
+#include <vsg/all.h>
+
+#include <mutex>
+#include <random>
+
+#include "TileInterest.h"
+#include "TilePack.h"
+
+// SimulatedTileServer is an in-process stand-in for a remote tile server such as readymap.org, so paging can be benchmarked
+// reproducibly and offline. It serves reads of paths of the form simulated_tiles/{z}/{x}/{y}<extension>, delaying each request to
+// simulate the network latency and bandwidth and failing a proportion of them. Tiles are served from a TilePackReader source
+// when one is assigned, otherwise an image is generated for each tile, coloured by level with a border so the tiles are visible.
+// Requests whose options carry a tripped "CancellationToken" are abandoned part way through. Like vsgXchange's curl ReaderWriter
+// tiles are read from, and tiles from the TilePackReader source written to, the options->fileCache when one is set.
+class SimulatedTileServer : public vsg::Inherit<vsg::ReaderWriter, SimulatedTileServer>
+{
+public:
+    SimulatedTileServer();
+
+    double latency = 0.05;             // mean seconds from request to the first byte
+    double latencyJitter = 0.025;      // latency is uniformly distributed over latency +/- latencyJitter
+    double bandwidth = 0.0;            // bytes per second shared by all requests in flight, 0 for unlimited
+    double errorRate = 0.0;            // proportion of requests that fail, 0 to 1
+    uint32_t tileSize = 256;           // dimensions of generated tiles
+    size_t generatedTileBytes = 20000; // size transferred for a generated tile, typical of a 256x256 jpeg
+
+    vsg::ref_ptr<TilePackReader> source;
+
+    // path template to use as TileReader::imageLayer.
+    vsg::Path tilePathTemplate() const;
+
+    vsg::ref_ptr<vsg::Object> read(const vsg::Path& path, vsg::ref_ptr<const vsg::Options> options = {}) const override;
+
+    struct Stats
+    {
+        uint64_t numRequests = 0;
+        uint64_t numFailed = 0;
+        uint64_t numCancelled = 0;
+        uint64_t bytesTransferred = 0;
+        std::vector<double> latencies; // milliseconds from request to the decoded tile being returned
+    };
+
+    Stats stats() const;
+
+protected:
+    vsg::ref_ptr<vsg::Data> generateTile(uint32_t x, uint32_t y, uint32_t level) const;
+
+    mutable std::mutex _mutex;
+    mutable std::mt19937 _random;
+    mutable Stats _stats;
+    mutable vsg::time_point _bandwidthAvailable; // when the simulated connection finishes transferring the requests already made
+};
+
+// return the p percentile, 0 to 100, of values.
+double percentile(std::vector<double> values, double p);
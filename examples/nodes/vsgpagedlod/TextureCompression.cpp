@@ -0,0 +1,200 @@
+#include "TextureCompression.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace
+{
+    uint16_t packRGB565(int r, int g, int b)
+    {
+        return static_cast<uint16_t>((((r * 31 + 127) / 255) << 11) | (((g * 63 + 127) / 255) << 5) | ((b * 31 + 127) / 255));
+    }
+
+    void unpackRGB565(uint16_t c, int* rgb)
+    {
+        int r = (c >> 11) & 31;
+        int g = (c >> 5) & 63;
+        int b = c & 31;
+        rgb[0] = (r << 3) | (r >> 2);
+        rgb[1] = (g << 2) | (g >> 4);
+        rgb[2] = (b << 3) | (b >> 2);
+    }
+
+    bool isPowerOfTwo(uint32_t value)
+    {
+        return value != 0 && (value & (value - 1)) == 0;
+    }
+
+    // halve the dimensions of a power of two image by averaging each 2x2 block of pixels.
+    std::vector<vsg::ubvec4> downsample(const std::vector<vsg::ubvec4>& pixels, uint32_t width, uint32_t height)
+    {
+        uint32_t halfWidth = width / 2;
+        uint32_t halfHeight = height / 2;
+        std::vector<vsg::ubvec4> result(halfWidth * halfHeight);
+        for (uint32_t r = 0; r < halfHeight; ++r)
+        {
+            const vsg::ubvec4* row0 = pixels.data() + (r * 2) * width;
+            const vsg::ubvec4* row1 = row0 + width;
+            vsg::ubvec4* output = result.data() + r * halfWidth;
+            for (uint32_t c = 0; c < halfWidth; ++c)
+            {
+                for (int i = 0; i < 4; ++i)
+                {
+                    output[c][i] = static_cast<uint8_t>((row0[c * 2][i] + row0[c * 2 + 1][i] + row1[c * 2][i] + row1[c * 2 + 1][i] + 2) / 4);
+                }
+            }
+        }
+        return result;
+    }
+} // namespace
+
+void encodeBC1Block(const vsg::ubvec4* pixels, uint8_t* block)
+{
+    int minColor[3] = {255, 255, 255};
+    int maxColor[3] = {0, 0, 0};
+    int sum[3] = {0, 0, 0};
+    for (int i = 0; i < 16; ++i)
+    {
+        for (int c = 0; c < 3; ++c)
+        {
+            int value = pixels[i][c];
+            minColor[c] = std::min(minColor[c], value);
+            maxColor[c] = std::max(maxColor[c], value);
+            sum[c] += value;
+        }
+    }
+
+    // pick the diagonal of the bounding box using the sign of the red/green and blue/green covariance, scaled by 16 to stay in integers
+    int covarianceRG = 0;
+    int covarianceBG = 0;
+    for (int i = 0; i < 16; ++i)
+    {
+        int g = pixels[i][1] * 16 - sum[1];
+        covarianceRG += (pixels[i][0] * 16 - sum[0]) * g;
+        covarianceBG += (pixels[i][2] * 16 - sum[2]) * g;
+    }
+    if (covarianceRG < 0) std::swap(minColor[0], maxColor[0]);
+    if (covarianceBG < 0) std::swap(minColor[2], maxColor[2]);
+
+    for (int c = 0; c < 3; ++c)
+    {
+        int inset = (maxColor[c] - minColor[c]) / 16;
+        minColor[c] += inset;
+        maxColor[c] -= inset;
+    }
+
+    uint16_t color0 = packRGB565(maxColor[0], maxColor[1], maxColor[2]);
+    uint16_t color1 = packRGB565(minColor[0], minColor[1], minColor[2]);
+
+    // color0 > color1 selects the 4 colour palette, equal endpoints mean a single colour block with all indices 0
+    if (color0 < color1) std::swap(color0, color1);
+
+    uint32_t indices = 0;
+    if (color0 != color1)
+    {
+        int endpoint0[3], endpoint1[3];
+        unpackRGB565(color0, endpoint0);
+        unpackRGB565(color1, endpoint1);
+
+        int direction[3] = {endpoint1[0] - endpoint0[0], endpoint1[1] - endpoint0[1], endpoint1[2] - endpoint0[2]};
+        int lengthSquared = direction[0] * direction[0] + direction[1] * direction[1] + direction[2] * direction[2];
+
+        // position along the line from endpoint0 to endpoint1 in thirds, mapped to the palette order of color0, color1, 2/3 color0 + 1/3 color1, 1/3 color0 + 2/3 color1
+        static const uint32_t paletteIndex[4] = {0, 2, 3, 1};
+        for (int i = 0; i < 16; ++i)
+        {
+            int projection = (pixels[i][0] - endpoint0[0]) * direction[0] + (pixels[i][1] - endpoint0[1]) * direction[1] + (pixels[i][2] - endpoint0[2]) * direction[2];
+            int step = projection <= 0 ? 0 : std::min(3, (projection * 6 + lengthSquared) / (lengthSquared * 2));
+            indices |= paletteIndex[step] << (i * 2);
+        }
+    }
+
+    // little endian layout of color0, color1 and the 2 bit indices with the first pixel in the lowest bits
+    block[0] = static_cast<uint8_t>(color0 & 0xff);
+    block[1] = static_cast<uint8_t>(color0 >> 8);
+    block[2] = static_cast<uint8_t>(color1 & 0xff);
+    block[3] = static_cast<uint8_t>(color1 >> 8);
+    for (int i = 0; i < 4; ++i) block[4 + i] = static_cast<uint8_t>((indices >> (i * 8)) & 0xff);
+}
+
+vsg::ref_ptr<vsg::Data> compressBC1(const vsg::Data& image)
+{
+    uint32_t width = image.width();
+    uint32_t height = image.height();
+    if (width < 4 || height < 4 || !isPowerOfTwo(width) || !isPowerOfTwo(height) || image.properties.maxNumMipmaps > 1) return {};
+
+    // copy to a tightly packed RGBA8 image to generate the mipmaps from
+    // the blocks are encoded from the stored values, so SRGB images stay SRGB and are decoded by the sampler as before
+    auto format = image.properties.format;
+    bool srgb = (format == VK_FORMAT_R8G8B8A8_SRGB || format == VK_FORMAT_R8G8B8_SRGB);
+
+    std::vector<vsg::ubvec4> pixels(width * height);
+    if (auto rgba = dynamic_cast<const vsg::ubvec4Array2D*>(&image); rgba && (format == VK_FORMAT_R8G8B8A8_UNORM || format == VK_FORMAT_R8G8B8A8_SRGB))
+    {
+        for (uint32_t r = 0; r < height; ++r)
+        {
+            for (uint32_t c = 0; c < width; ++c) pixels[r * width + c] = rgba->at(c, r);
+        }
+    }
+    else if (auto rgb = dynamic_cast<const vsg::ubvec3Array2D*>(&image); rgb && (format == VK_FORMAT_R8G8B8_UNORM || format == VK_FORMAT_R8G8B8_SRGB))
+    {
+        for (uint32_t r = 0; r < height; ++r)
+        {
+            for (uint32_t c = 0; c < width; ++c)
+            {
+                auto& pixel = rgb->at(c, r);
+                pixels[r * width + c].set(pixel.r, pixel.g, pixel.b, 255);
+            }
+        }
+    }
+    else
+    {
+        return {};
+    }
+
+    // mipmap levels down to a single 4x4 block in the smaller dimension
+    uint32_t numMipmaps = 1;
+    while ((std::min(width, height) >> numMipmaps) >= 4) ++numMipmaps;
+
+    size_t numBlocks = 0;
+    for (uint32_t level = 0; level < numMipmaps; ++level) numBlocks += ((width >> level) / 4) * ((height >> level) / 4);
+
+    // all the mipmap levels are held contiguously in one block of storage, as vsg expects for data with mipmaps
+    auto storage = vsg::ubyteArray::create(static_cast<uint32_t>(numBlocks * sizeof(vsg::block64)));
+    uint8_t* output = storage->data();
+
+    uint32_t levelWidth = width;
+    uint32_t levelHeight = height;
+    vsg::ubvec4 blockPixels[16];
+    for (uint32_t level = 0; level < numMipmaps; ++level)
+    {
+        if (level > 0)
+        {
+            pixels = downsample(pixels, levelWidth, levelHeight);
+            levelWidth /= 2;
+            levelHeight /= 2;
+        }
+
+        for (uint32_t by = 0; by < levelHeight; by += 4)
+        {
+            for (uint32_t bx = 0; bx < levelWidth; bx += 4)
+            {
+                for (uint32_t r = 0; r < 4; ++r)
+                {
+                    std::memcpy(blockPixels + r * 4, pixels.data() + (by + r) * levelWidth + bx, 4 * sizeof(vsg::ubvec4));
+                }
+                encodeBC1Block(blockPixels, output);
+                output += sizeof(vsg::block64);
+            }
+        }
+    }
+
+    vsg::Data::Properties properties;
+    properties.format = srgb ? VK_FORMAT_BC1_RGB_SRGB_BLOCK : VK_FORMAT_BC1_RGB_UNORM_BLOCK;
+    properties.blockWidth = 4;
+    properties.blockHeight = 4;
+    properties.maxNumMipmaps = static_cast<uint8_t>(numMipmaps);
+    properties.origin = image.properties.origin;
+
+    return vsg::block64Array2D::create(storage, 0, sizeof(vsg::block64), width / 4, height / 4, properties);
+}
@@ -0,0 +1,14 @@
+#pragma once
+
+#include <vsg/all.h>
+
+// Compress an R8G8B8A8 or R8G8B8 image, UNORM or SRGB, to BC1 (DXT1) of the matching encoding, generating its mipmaps on the CPU as compressed images can't have their
+// mipmaps generated by the GPU blits that vsg uses for uncompressed images. BC1 stores each 4x4 block of pixels in 8 bytes, 8x
+// smaller than RGBA8, at the cost of dropping alpha, which imagery tiles don't use.
+// Returns null if the image isn't one of the supported formats or its dimensions aren't powers of two of at least 4.
+vsg::ref_ptr<vsg::Data> compressBC1(const vsg::Data& image);
+
+// encode a 4x4 block of pixels, in row order, to BC1. The endpoints are the corners of the block's colour bounding box, on
+// the diagonal that follows the colours' correlation, inset slightly to reduce the quantization error. Each pixel is then
+// assigned the palette entry nearest its projection onto the line between the endpoints.
+void encodeBC1Block(const vsg::ubvec4* pixels, uint8_t* block);
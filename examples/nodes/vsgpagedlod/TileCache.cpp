@@ -0,0 +1,92 @@
+#include "TileCache.h"
+
+TileCache::TileCache(size_t in_maxBytes) :
+    maxBytes(in_maxBytes)
+{
+}
+
+vsg::ref_ptr<vsg::Data> TileCache::get(const Key& key)
+{
+    std::scoped_lock<std::mutex> lock(_mutex);
+
+    auto itr = _index.find(key);
+    if (itr == _index.end())
+    {
+        ++_stats.misses;
+        return {};
+    }
+
+    ++_stats.hits;
+    _entries.splice(_entries.begin(), _entries, itr->second);
+
+    auto& entry = *itr->second;
+    if (entry.prefetched)
+    {
+        entry.prefetched = false;
+        ++_stats.prefetchedUsed;
+        --_stats.prefetchedPending;
+    }
+
+    return entry.data;
+}
+
+bool TileCache::contains(const Key& key) const
+{
+    std::scoped_lock<std::mutex> lock(_mutex);
+    return _index.count(key) != 0;
+}
+
+void TileCache::insert(const Key& key, vsg::ref_ptr<vsg::Data> data, bool prefetched)
+{
+    if (!data) return;
+
+    size_t size = data->dataSize();
+    if (size > maxBytes) return;
+
+    std::scoped_lock<std::mutex> lock(_mutex);
+
+    // another thread may have read the same tile in the meantime
+    if (auto itr = _index.find(key); itr != _index.end())
+    {
+        // leave tiles already read for the DatabasePager as they are, they aren't a prefetch
+        if (prefetched) return;
+
+        if (itr->second->prefetched) --_stats.prefetchedPending;
+        _stats.bytes -= itr->second->size;
+        _entries.erase(itr->second);
+        _index.erase(itr);
+        --_stats.numTiles;
+    }
+
+    while (!_entries.empty() && _stats.bytes + size > maxBytes)
+    {
+        auto& last = _entries.back();
+        _stats.bytes -= last.size;
+        if (last.prefetched)
+        {
+            ++_stats.prefetchedEvicted;
+            --_stats.prefetchedPending;
+        }
+        _index.erase(last.key);
+        _entries.pop_back();
+        --_stats.numTiles;
+        ++_stats.evictions;
+    }
+
+    _entries.push_front(Entry{key, data, size, prefetched});
+    _index[key] = _entries.begin();
+    _stats.bytes += size;
+    ++_stats.numTiles;
+
+    if (prefetched)
+    {
+        ++_stats.prefetched;
+        ++_stats.prefetchedPending;
+    }
+}
+
+TileCache::Stats TileCache::stats() const
+{
+    std::scoped_lock<std::mutex> lock(_mutex);
+    return _stats;
+}
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <vsg/all.h>
+
+#include <list>
+#include <map>
+#include <mutex>
+#include <tuple>
+
+// TileCache keeps the most recently used decoded image tiles in memory, up to a byte budget, so that tiles reloaded by the
+// DatabasePager soon after being expired, such as when orbiting back and forth over an area, don't need reading and decoding again.
+class TileCache : public vsg::Inherit<vsg::Object, TileCache>
+{
+public:
+    explicit TileCache(size_t in_maxBytes);
+
+    struct Key
+    {
+        uint32_t x;
+        uint32_t y;
+        uint32_t level;
+
+        bool operator<(const Key& rhs) const { return std::tie(level, y, x) < std::tie(rhs.level, rhs.y, rhs.x); }
+    };
+
+    const size_t maxBytes;
+
+    // return the cached tile, marking it as the most recently used, or null if it isn't in the cache.
+    vsg::ref_ptr<vsg::Data> get(const Key& key);
+
+    // return true if the tile is in the cache, without affecting its position or the hit/miss stats.
+    bool contains(const Key& key) const;
+
+    // add tile, evicting the least recently used tiles to keep within maxBytes.
+    // prefetched tiles are tracked until first requested with get() so the prefetching can be assessed.
+    void insert(const Key& key, vsg::ref_ptr<vsg::Data> data, bool prefetched = false);
+
+    struct Stats
+    {
+        uint64_t hits = 0;
+        uint64_t misses = 0;
+        uint64_t evictions = 0;
+        size_t numTiles = 0;
+        size_t bytes = 0;
+
+        uint64_t prefetched = 0;
+        uint64_t prefetchedUsed = 0;
+        uint64_t prefetchedEvicted = 0; // evicted before being used
+        size_t prefetchedPending = 0;   // still in the cache and not yet used
+    };
+
+    Stats stats() const;
+
+protected:
+    struct Entry
+    {
+        Key key;
+        vsg::ref_ptr<vsg::Data> data;
+        size_t size;
+        bool prefetched;
+    };
+
+    using Entries = std::list<Entry>;
+
+    mutable std::mutex _mutex;
+    Entries _entries; // most recently used first
+    std::map<Key, Entries::iterator> _index;
+    Stats _stats;
+};
@@ -0,0 +1,51 @@
+#include "TileInterest.h"
+
+CancellationToken::CancellationToken(vsg::ref_ptr<const TileInterest> in_interest, vsg::ref_ptr<vsg::PagedLOD> in_plod) :
+    _interest(in_interest),
+    _plod(in_plod)
+{
+}
+
+bool CancellationToken::cancelled() const
+{
+    // a PagedLOD that has been deleted, because its parent tile was expired, can no longer need its subtiles
+    vsg::ref_ptr<vsg::PagedLOD> plod = _plod;
+    if (!plod) return true;
+
+    uint64_t frameCount = _interest->frameCount();
+    uint64_t frameHighResLastUsed = plod->frameHighResLastUsed;
+    return frameCount > frameHighResLastUsed && (frameCount - frameHighResLastUsed) > _interest->maxFramesOutOfInterest;
+}
+
+void TileInterest::add(const vsg::Path& filename, vsg::ref_ptr<vsg::PagedLOD> plod)
+{
+    std::scoped_lock<std::mutex> lock(_mutex);
+
+    _plods[filename] = plod;
+
+    // periodically remove the entries of PagedLOD that have been deleted so the map only grows with the number of loaded tiles
+    if (++_numAddedSinceCleanup >= 1024)
+    {
+        for (auto itr = _plods.begin(); itr != _plods.end();)
+        {
+            if (vsg::ref_ptr<vsg::PagedLOD> existing = itr->second; existing)
+                ++itr;
+            else
+                itr = _plods.erase(itr);
+        }
+        _numAddedSinceCleanup = 0;
+    }
+}
+
+vsg::ref_ptr<CancellationToken> TileInterest::token(const vsg::Path& filename) const
+{
+    std::scoped_lock<std::mutex> lock(_mutex);
+
+    auto itr = _plods.find(filename);
+    if (itr == _plods.end()) return {};
+
+    vsg::ref_ptr<vsg::PagedLOD> plod = itr->second;
+    if (!plod) return {};
+
+    return CancellationToken::create(vsg::ref_ptr<const TileInterest>(this), plod);
+}
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <vsg/all.h>
+
+#include <atomic>
+#include <map>
+#include <mutex>
+
+class TileInterest;
+
+// CancellationToken for the load of a PagedLOD's subtiles, tripped once the PagedLOD's high resolution child stops being
+// required by the RecordTraversal, i.e. when the camera has moved on before the load completed.
+class CancellationToken : public vsg::Inherit<vsg::Object, CancellationToken>
+{
+public:
+    CancellationToken(vsg::ref_ptr<const TileInterest> in_interest, vsg::ref_ptr<vsg::PagedLOD> in_plod);
+
+    bool cancelled() const;
+
+protected:
+    vsg::ref_ptr<const TileInterest> _interest;
+    vsg::observer_ptr<vsg::PagedLOD> _plod;
+};
+
+// TileInterest tracks the PagedLOD created for each tile so that a load can be related back to the PagedLOD that requested
+// it, as the DatabasePager only passes on the PagedLOD's filename and options. The viewer's frame count is passed in each
+// frame to compare with the frame the PagedLOD's high resolution child was last required.
+class TileInterest : public vsg::Inherit<vsg::Object, TileInterest>
+{
+public:
+    // frames a PagedLOD's high resolution child can go unused before loads for it are cancelled, matching the DatabasePager's
+    // own check before it starts a read.
+    uint64_t maxFramesOutOfInterest = 1;
+
+    void setFrameCount(uint64_t frameCount) { _frameCount = frameCount; }
+    uint64_t frameCount() const { return _frameCount; }
+
+    // register the PagedLOD that will request filename.
+    void add(const vsg::Path& filename, vsg::ref_ptr<vsg::PagedLOD> plod);
+
+    // return the token for the load of filename, or null if no PagedLOD has been registered for it.
+    vsg::ref_ptr<CancellationToken> token(const vsg::Path& filename) const;
+
+protected:
+    std::atomic_uint64_t _frameCount{0};
+
+    mutable std::mutex _mutex;
+    std::map<vsg::Path, vsg::observer_ptr<vsg::PagedLOD>> _plods;
+    size_t _numAddedSinceCleanup = 0;
+};
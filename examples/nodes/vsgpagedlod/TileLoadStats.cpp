@@ -0,0 +1,174 @@
+#include "TileLoadStats.h"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+
+void Histogram::add(double value)
+{
+    if (value > 0.0)
+    {
+        int index = static_cast<int>(std::floor((std::log2(value) - minExponent) * bucketsPerDoubling));
+        index = std::clamp(index, 0, static_cast<int>(numBuckets) - 1);
+        _buckets[index].fetch_add(1, std::memory_order_relaxed);
+    }
+    else
+    {
+        _zeros.fetch_add(1, std::memory_order_relaxed);
+    }
+    _count.fetch_add(1, std::memory_order_relaxed);
+
+    double sum = _sum.load(std::memory_order_relaxed);
+    while (!_sum.compare_exchange_weak(sum, sum + value, std::memory_order_relaxed)) {}
+
+    double max = _max.load(std::memory_order_relaxed);
+    while (value > max && !_max.compare_exchange_weak(max, value, std::memory_order_relaxed)) {}
+}
+
+double Histogram::mean() const
+{
+    auto n = count();
+    return n > 0 ? _sum.load(std::memory_order_relaxed) / static_cast<double>(n) : 0.0;
+}
+
+double Histogram::percentile(double p) const
+{
+    auto n = count();
+    if (n == 0) return 0.0;
+
+    auto target = static_cast<uint64_t>(std::ceil(p / 100.0 * static_cast<double>(n)));
+    uint64_t cumulative = _zeros.load(std::memory_order_relaxed);
+    if (cumulative >= target) return 0.0;
+
+    for (size_t i = 0; i < numBuckets; ++i)
+    {
+        cumulative += _buckets[i].load(std::memory_order_relaxed);
+        if (cumulative >= target)
+        {
+            // geometric middle of the bucket, clamped so it's never above the largest value recorded
+            double value = std::exp2(minExponent + (static_cast<double>(i) + 0.5) / bucketsPerDoubling);
+            return std::min(value, max());
+        }
+    }
+    return max();
+}
+
+const char* TileLoadStats::stageName(Stage stage)
+{
+    switch (stage)
+    {
+    case FETCH: return "fetch";
+    case DECODE: return "decode";
+    case ENCODE: return "encode";
+    case READ: return "read";
+    case MESH: return "mesh";
+    case BOUND: return "bound";
+    case SUBTILE: return "subtile";
+    case COMPILE: return "compile";
+    case MERGE: return "merge";
+    default: return "unknown";
+    }
+}
+
+void TileLoadStats::report(std::ostream& out) const
+{
+    out << "tile load stages (ms)      count       mean        p50        p95        p99        max" << std::endl;
+    auto line = [&](const char* name, const Histogram& histogram) {
+        out << "    " << std::left << std::setw(16) << name << std::right << std::setw(12) << histogram.count() << std::fixed << std::setprecision(3)
+            << std::setw(11) << histogram.mean() << std::setw(11) << histogram.percentile(50.0) << std::setw(11) << histogram.percentile(95.0)
+            << std::setw(11) << histogram.percentile(99.0) << std::setw(11) << histogram.max() << std::defaultfloat << std::endl;
+    };
+
+    for (int i = 0; i < NUM_STAGES; ++i)
+    {
+        auto stage = static_cast<Stage>(i);
+        if (_stages[i].count() > 0) line(stageName(stage), _stages[i]);
+    }
+    line("queue depth", queueDepth);
+}
+
+vsg::ref_ptr<vsg::Object> TileLoadStatsReaderWriter::read(const vsg::Path& filename, vsg::ref_ptr<const vsg::Options> options) const
+{
+    // tiles are read by TileReader, which records its own stages, and whose vsg::read() of the images then comes back here
+    if (vsg::lowerCaseFileExtension(filename) == ".tile") return {};
+
+    // when the nested vsg::read() of this filename comes back through this ReaderWriter return null so it falls through to
+    // the other ReaderWriters, reads of other files made while decoding it are still recorded
+    thread_local const vsg::Path* s_activeFilename = nullptr;
+    if (s_activeFilename && *s_activeFilename == filename) return {};
+
+    struct ActiveRead
+    {
+        const vsg::Path* previousFilename;
+        explicit ActiveRead(const vsg::Path& activeFilename) :
+            previousFilename(s_activeFilename) { s_activeFilename = &activeFilename; }
+        ~ActiveRead() { s_activeFilename = previousFilename; }
+    } activeRead(filename);
+
+    auto& stats = TileLoadStats::instance();
+    auto start = vsg::clock::now();
+
+    if (auto filePath = vsg::findFile(filename, options))
+    {
+        std::vector<uint8_t> buffer;
+        std::ifstream fin(filePath.c_str(), std::ios::in | std::ios::binary | std::ios::ate);
+        if (fin && fin.tellg() > 0)
+        {
+            buffer.resize(static_cast<size_t>(fin.tellg()));
+            fin.seekg(0);
+            fin.read(reinterpret_cast<char*>(buffer.data()), buffer.size());
+        }
+
+        if (fin.good() && !buffer.empty())
+        {
+            auto local_options = vsg::Options::create_if(options, *options);
+            if (!local_options) local_options = vsg::Options::create();
+            local_options->extensionHint = vsg::lowerCaseFileExtension(filename);
+
+            auto start_decode = vsg::clock::now();
+            if (auto object = vsg::read(buffer.data(), buffer.size(), local_options))
+            {
+                stats.add(TileLoadStats::FETCH, start, start_decode);
+                stats.add(TileLoadStats::DECODE, start_decode, vsg::clock::now());
+                return object;
+            }
+        }
+
+        // not all ReaderWriters support reading from memory so fallback to reading the file directly
+    }
+
+    auto object = vsg::read(filename, options);
+    if (object) stats.add(TileLoadStats::FETCH, start, vsg::clock::now());
+    return object;
+}
+
+void TileGroup::accept(vsg::Visitor& visitor)
+{
+    Inherit::accept(visitor);
+
+    // the DatabasePager compiles the subtiles before passing them on to be merged, so the first CompileTraversal is that compile
+    if (!_compiled && dynamic_cast<vsg::CompileTraversal*>(&visitor))
+    {
+        _compileCompleted = vsg::clock::now();
+        _compiled.store(true, std::memory_order_release);
+        TileLoadStats::instance().add(TileLoadStats::COMPILE, readCompleted, _compileCompleted);
+
+        if (memoryBudget) memoryBudget->add(filename, cpuBytes, gpuBytes);
+    }
+}
+
+TileGroup::~TileGroup()
+{
+    if (_compiled && memoryBudget) memoryBudget->remove(filename, cpuBytes, gpuBytes);
+}
+
+void TileGroup::accept(vsg::RecordTraversal& visitor) const
+{
+    if (!_recorded.load(std::memory_order_relaxed) && _compiled.load(std::memory_order_acquire) && !_recorded.exchange(true))
+    {
+        TileLoadStats::instance().add(TileLoadStats::MERGE, _compileCompleted, vsg::clock::now());
+    }
+
+    Inherit::accept(visitor);
+}
@@ -0,0 +1,113 @@
+#pragma once
+
+#include <vsg/all.h>
+
+#include "TileMemory.h"
+
+#include <array>
+#include <atomic>
+#include <ostream>
+
+// Histogram of values, such as milliseconds, in logarithmically spaced buckets with 8 buckets per doubling, so
+// percentiles are accurate to within ~5%. Values are added with relaxed atomics so that the reading threads can record
+// them concurrently without locking.
+class Histogram
+{
+public:
+    static constexpr int bucketsPerDoubling = 8;
+    static constexpr int minExponent = -10; // values below 2^-10 are counted in the first bucket
+    static constexpr int maxExponent = 20;  // values above 2^20 are counted in the last bucket
+    static constexpr size_t numBuckets = (maxExponent - minExponent) * bucketsPerDoubling;
+
+    void add(double value);
+
+    uint64_t count() const { return _count.load(std::memory_order_relaxed); }
+    double mean() const;
+    double max() const { return _max.load(std::memory_order_relaxed); }
+
+    // approximate value below which p percent of the values fall, 0 to 100.
+    double percentile(double p) const;
+
+protected:
+    std::array<std::atomic_uint64_t, numBuckets> _buckets = {};
+    std::atomic_uint64_t _count{0};
+    std::atomic_uint64_t _zeros{0}; // values <= 0, such as an empty queue, so they are reported as 0 rather than the first bucket
+    std::atomic<double> _sum{0.0};
+    std::atomic<double> _max{0.0};
+};
+
+// TileLoadStats breaks the time to load a tile down by stage so it's clear whether I/O, CPU or GPU upload is the bottleneck.
+class TileLoadStats
+{
+public:
+    static TileLoadStats& instance()
+    {
+        static TileLoadStats s_tileLoadStats;
+        return s_tileLoadStats;
+    }
+
+    enum Stage
+    {
+        FETCH,   // reading an image's encoded data from file or server, recorded by BatchReader, SimulatedTileServer and TileLoadStatsReaderWriter
+        DECODE,  // decoding an image's data, recorded by BatchReader, SimulatedTileServer and TileLoadStatsReaderWriter
+        ENCODE,  // compressing an image and generating its mipmaps, when TileReader::compressTextures is set
+        READ,    // reading all a subtile's images, covering both the fetch and decode of the 4 images
+        MESH,    // building a tile's geometry and state
+        BOUND,   // computing a tile's bound
+        SUBTILE, // TileReader::read_subtile() from start to finish
+        COMPILE, // from read_subtile() returning to the DatabasePager's compile traversal of the subtiles completing
+        MERGE,   // from the compile traversal to the subtiles first being recorded, covering the GPU transfer and merge
+        NUM_STAGES
+    };
+
+    static const char* stageName(Stage stage);
+
+    void add(Stage stage, double milliseconds) { _stages[stage].add(milliseconds); }
+    void add(Stage stage, vsg::time_point start, vsg::time_point end) { add(stage, std::chrono::duration<double, std::chrono::milliseconds::period>(end - start).count()); }
+
+    const Histogram& stage(Stage stage) const { return _stages[stage]; }
+
+    // pending DatabasePager requests, sampled each frame.
+    Histogram queueDepth;
+
+    void report(std::ostream& out) const;
+
+protected:
+    std::array<Histogram, NUM_STAGES> _stages;
+};
+
+// TileLoadStatsReaderWriter records the FETCH and DECODE stages of the reads that go through vsg::read(), which is how TileReader
+// reads the images when neither BatchReader nor SimulatedTileServer, which record their own, are used. Local files are read
+// into memory and then decoded from it so the two stages can be timed separately. Other reads, such as http tiles read by
+// vsgXchange's curl ReaderWriter or tiles from a TilePack, are fetched and decoded by a single ReaderWriter call, so their
+// whole read is recorded as FETCH and they have no DECODE. Reads of .tile files are left to the TileReader.
+class TileLoadStatsReaderWriter : public vsg::Inherit<vsg::ReaderWriter, TileLoadStatsReaderWriter>
+{
+public:
+    vsg::ref_ptr<vsg::Object> read(const vsg::Path& filename, vsg::ref_ptr<const vsg::Options> options = {}) const override;
+};
+
+// TileGroup is the Group returned by TileReader::read_subtile(), it timestamps the DatabasePager's compile traversal and the first
+// record traversal of the subtiles to provide the COMPILE and MERGE stages that happen outside of the TileReader, and adds its
+// memory to the memoryBudget from being compiled until it's deleted.
+class TileGroup : public vsg::Inherit<vsg::Group, TileGroup>
+{
+public:
+    vsg::time_point readCompleted;
+
+    vsg::Path filename;
+    size_t cpuBytes = 0;
+    size_t gpuBytes = 0;
+    vsg::ref_ptr<TileMemoryBudget> memoryBudget;
+
+    using vsg::Inherit<vsg::Group, TileGroup>::accept;
+    void accept(vsg::Visitor& visitor) override;
+    void accept(vsg::RecordTraversal& visitor) const override;
+
+protected:
+    virtual ~TileGroup();
+
+    mutable std::atomic_bool _compiled{false};
+    mutable std::atomic_bool _recorded{false};
+    mutable vsg::time_point _compileCompleted;
+};
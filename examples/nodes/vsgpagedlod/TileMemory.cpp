@@ -0,0 +1,111 @@
+#include "TileMemory.h"
+
+#include <algorithm>
+
+void CollectTileMemory::apply(const vsg::Object& object)
+{
+    object.traverse(*this);
+}
+
+void CollectTileMemory::apply(const vsg::PagedLOD& plod)
+{
+    if (plod.options) options.insert(plod.options.get());
+    plod.traverse(*this);
+}
+
+void CollectTileMemory::apply(const vsg::StateGroup& stateGroup)
+{
+    // the texture is bound by the StateGroup's state commands, which aren't visited by the standard traversal
+    for (auto& stateCommand : stateGroup.stateCommands) stateCommand->accept(*this);
+    stateGroup.traverse(*this);
+}
+
+void CollectTileMemory::apply(const vsg::BindDescriptorSets& bds)
+{
+    for (auto& descriptorSet : bds.descriptorSets) descriptorSet->accept(*this);
+}
+
+void CollectTileMemory::apply(const vsg::DescriptorSet& descriptorSet)
+{
+    for (auto& descriptor : descriptorSet.descriptors) descriptor->accept(*this);
+}
+
+void CollectTileMemory::apply(const vsg::BindVertexBuffers& bvb)
+{
+    for (auto& array : bvb.arrays) addGeometry(array->data);
+}
+
+void CollectTileMemory::apply(const vsg::BindIndexBuffer& bib)
+{
+    ++numTiles;
+    if (bib.indices) addGeometry(bib.indices->data);
+}
+
+void CollectTileMemory::apply(const vsg::DescriptorImage& di)
+{
+    for (auto& imageInfo : di.imageInfoList)
+    {
+        if (imageInfo->imageView && imageInfo->imageView->image && imageInfo->imageView->image->data) images.insert(imageInfo->imageView->image->data.get());
+    }
+}
+
+void CollectTileMemory::addGeometry(const vsg::ref_ptr<vsg::Data>& data)
+{
+    if (!data) return;
+    geometry.insert(data.get());
+    geometryReferencedSize += data->dataSize();
+}
+
+size_t CollectTileMemory::totalSize(const std::set<const vsg::Data*>& dataSet)
+{
+    size_t size = 0;
+    for (auto& data : dataSet) size += data->dataSize();
+    return size;
+}
+
+TileMemoryBudget::TileMemoryBudget(size_t in_maxBytes) :
+    maxBytes(in_maxBytes)
+{
+}
+
+void TileMemoryBudget::add(const vsg::Path& filename, size_t cpuBytes, size_t gpuBytes)
+{
+    std::scoped_lock<std::mutex> lock(_mutex);
+
+    ++_stats.numTiles;
+    ++_stats.numLoaded;
+    if (_expired.erase(filename) > 0) ++_stats.numReloaded;
+
+    _stats.cpuBytes += cpuBytes;
+    _stats.gpuBytes += gpuBytes;
+    _stats.peakBytes = std::max(_stats.peakBytes, _stats.cpuBytes + _stats.gpuBytes);
+}
+
+void TileMemoryBudget::remove(const vsg::Path& filename, size_t cpuBytes, size_t gpuBytes)
+{
+    std::scoped_lock<std::mutex> lock(_mutex);
+
+    --_stats.numTiles;
+    ++_stats.numExpired;
+    _expired.insert(filename);
+
+    _stats.cpuBytes -= cpuBytes;
+    _stats.gpuBytes -= gpuBytes;
+}
+
+void TileMemoryBudget::update(vsg::DatabasePager& databasePager)
+{
+    std::scoped_lock<std::mutex> lock(_mutex);
+
+    if (maxBytes == 0 || _stats.numTiles == 0) return;
+
+    double averageBytes = static_cast<double>(_stats.cpuBytes + _stats.gpuBytes) / static_cast<double>(_stats.numTiles);
+    _stats.targetNumTiles = std::max(minNumTiles, static_cast<uint32_t>(static_cast<double>(maxBytes) / averageBytes));
+    databasePager.targetMaxNumPagedLODWithHighResSubgraphs = _stats.targetNumTiles;
+}
+
+TileMemoryBudget::Stats TileMemoryBudget::stats() const
+{
+    std::scoped_lock<std::mutex> lock(_mutex);
+    return _stats;
+}
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <vsg/all.h>
+
+#include <mutex>
+#include <set>
+
+// collect the data referenced by the loaded tiles, counting data shared between tiles both once and per reference
+// to show how much memory sharing saves. Sizes are of the CPU side data which the GPU buffers and images mirror.
+class CollectTileMemory : public vsg::Inherit<vsg::ConstVisitor, CollectTileMemory>
+{
+public:
+    size_t numTiles = 0;
+    std::set<const vsg::Data*> geometry;
+    std::set<const vsg::Data*> images;
+    std::set<const vsg::Options*> options;
+    size_t geometryReferencedSize = 0;
+
+    void apply(const vsg::Object& object) override;
+    void apply(const vsg::PagedLOD& plod) override;
+    void apply(const vsg::StateGroup& stateGroup) override;
+    void apply(const vsg::BindDescriptorSets& bds) override;
+    void apply(const vsg::DescriptorSet& descriptorSet) override;
+    void apply(const vsg::BindVertexBuffers& bvb) override;
+    void apply(const vsg::BindIndexBuffer& bib) override;
+    void apply(const vsg::DescriptorImage& di) override;
+
+    void addGeometry(const vsg::ref_ptr<vsg::Data>& data);
+
+    static size_t totalSize(const std::set<const vsg::Data*>& dataSet);
+};
+
+// TileMemoryBudget keeps the memory used by the loaded subtiles under a byte budget. The DatabasePager expires the high
+// resolution subgraphs of the least recently visible PagedLOD once there are more than its target number of them, so each
+// frame the target is set to the number of subtiles that fit in the budget at the current average subtile size, converting
+// the DatabasePager's count based policy into a byte based one.
+class TileMemoryBudget : public vsg::Inherit<vsg::Object, TileMemoryBudget>
+{
+public:
+    explicit TileMemoryBudget(size_t in_maxBytes);
+
+    const size_t maxBytes; // CPU and GPU bytes, 0 to just track the memory used
+    uint32_t minNumTiles = 16;
+
+    // called as subtiles become resident, when the DatabasePager compiles them, and when they are deleted after being expired.
+    void add(const vsg::Path& filename, size_t cpuBytes, size_t gpuBytes);
+    void remove(const vsg::Path& filename, size_t cpuBytes, size_t gpuBytes);
+
+    // set the DatabasePager's target number of subtiles to fit in the budget, called each frame.
+    void update(vsg::DatabasePager& databasePager);
+
+    struct Stats
+    {
+        size_t numTiles = 0;
+        size_t cpuBytes = 0;
+        size_t gpuBytes = 0;
+        size_t peakBytes = 0;
+        uint32_t targetNumTiles = 0;
+
+        uint64_t numLoaded = 0;
+        uint64_t numExpired = 0;
+        uint64_t numReloaded = 0; // loads of subtiles that had previously been expired
+    };
+
+    Stats stats() const;
+
+protected:
+    mutable std::mutex _mutex;
+    Stats _stats;
+    std::set<vsg::Path> _expired;
+};
@@ -0,0 +1,188 @@
+#include "TilePrefetcher.h"
+
+TilePrefetcher::TilePrefetcher(vsg::ref_ptr<TileReader> in_tileReader, vsg::ref_ptr<const vsg::Options> in_options, uint32_t numThreads) :
+    _tileReader(in_tileReader),
+    _options(in_options)
+{
+    for (uint32_t i = 0; i < std::max(numThreads, 1u); ++i)
+    {
+        threads.emplace_back([this]() { run(); });
+    }
+}
+
+TilePrefetcher::~TilePrefetcher()
+{
+    stop();
+}
+
+void TilePrefetcher::update(double time, const vsg::LookAt& lookAt)
+{
+    auto& eye = lookAt.eye;
+
+    if (_first)
+    {
+        _first = false;
+    }
+    else if (double dt = time - _previousTime; dt > 0.0)
+    {
+        // smooth the velocity so a single uneven frame doesn't throw the prediction
+        _velocity = _velocity * 0.5 + ((eye - _previousEye) / dt) * 0.5;
+    }
+
+    _previousTime = time;
+    _previousEye = eye;
+
+    std::vector<View> views;
+    for (uint32_t i = 1; i <= numSamples; ++i)
+    {
+        auto offset = _velocity * (lookAhead * static_cast<double>(i) / static_cast<double>(numSamples));
+        views.push_back(View{eye + offset, vsg::lookAt(eye + offset, lookAt.center + offset, lookAt.up)});
+    }
+    request(views);
+}
+
+void TilePrefetcher::update(double time, const vsg::AnimationPath& path)
+{
+    std::vector<View> views;
+    for (uint32_t i = 1; i <= numSamples; ++i)
+    {
+        // the path's matrices place the camera in the world, so their inverse is the view matrix
+        auto matrix = path.computeMatrix(time + lookAhead * static_cast<double>(i) / static_cast<double>(numSamples));
+        views.push_back(View{vsg::dvec3(matrix[3][0], matrix[3][1], matrix[3][2]), vsg::inverse(matrix)});
+    }
+    request(views);
+}
+
+void TilePrefetcher::request(const std::vector<View>& views)
+{
+    auto& tileReader = *_tileReader;
+
+    // walk the tile quad tree from each predicted eye point, nearest in time first, selecting the tiles whose PagedLOD
+    // would request their subtile, i.e. the same screen height ratio test that the RecordTraversal applies to the bounds.
+    std::vector<TileCache::Key> subtiles;
+    std::set<TileCache::Key> visited;
+    for (auto& [eye, viewMatrix] : views)
+    {
+        // the left, right, bottom and top planes of the predicted view frustum in world coordinates, from the rows of
+        // projection * view. Points behind the eye fail at least one of them, and the LOD test limits the distance, so
+        // the near and far planes aren't needed.
+        std::vector<vsg::dvec4> planes;
+        if (projection)
+        {
+            auto m = projection->transform() * viewMatrix;
+            for (int r = 0; r < 2; ++r)
+            {
+                for (double sign : {1.0, -1.0})
+                {
+                    vsg::dvec4 plane(m[0][3] + sign * m[0][r], m[1][3] + sign * m[1][r], m[2][3] + sign * m[2][r], m[3][3] + sign * m[3][r]);
+                    double length = vsg::length(vsg::dvec3(plane.x, plane.y, plane.z));
+                    if (length > 0.0) planes.push_back(plane / length);
+                }
+            }
+        }
+
+        auto outsideFrustum = [&](const vsg::dsphere& bound) {
+            for (auto& plane : planes)
+            {
+                if (plane.x * bound.center.x + plane.y * bound.center.y + plane.z * bound.center.z + plane.w < -bound.radius) return true;
+            }
+            return false;
+        };
+
+        std::deque<TileCache::Key> tiles;
+        for (uint32_t y = 0; y < tileReader.noY; ++y)
+        {
+            for (uint32_t x = 0; x < tileReader.noX; ++x)
+            {
+                tiles.push_back(TileCache::Key{x, y, 0});
+            }
+        }
+
+        while (!tiles.empty() && subtiles.size() < maxPending)
+        {
+            auto tile = tiles.front();
+            tiles.pop_front();
+
+            // tiles at maxLevel have no PagedLOD so nothing below them to prefetch
+            if (tile.level >= tileReader.maxLevel) continue;
+
+            auto bound = tileReader.computeTileBound(tile.x, tile.y, tile.level);
+            double ratio = (tile.level == 0) ? 0.25 : tileReader.lodTransitionScreenHeightRatio;
+            if (bound.radius * lodScale <= ratio * vsg::length(bound.center - eye)) continue;
+
+            // the RecordTraversal culls the PagedLOD outside the view frustum, so won't request their subtiles or traverse their children
+            if (outsideFrustum(bound)) continue;
+
+            if (visited.insert(tile).second && !tileReader.subtileCached(tile.x, tile.y, tile.level))
+            {
+                subtiles.push_back(tile);
+            }
+
+            for (uint32_t dy = 0; dy < 2; ++dy)
+            {
+                for (uint32_t dx = 0; dx < 2; ++dx)
+                {
+                    tiles.push_back(TileCache::Key{tile.x * 2 + dx, tile.y * 2 + dy, tile.level + 1});
+                }
+            }
+        }
+    }
+
+    std::set<TileCache::Key> predicted(subtiles.begin(), subtiles.end());
+
+    std::scoped_lock<std::mutex> lock(_mutex);
+
+    std::set<TileCache::Key> previous(_pending.begin(), _pending.end());
+    for (auto& key : previous)
+    {
+        if (predicted.count(key) == 0) ++numDropped;
+    }
+
+    _pending.clear();
+    for (auto& key : subtiles)
+    {
+        // subtiles already being read will be in the tileCache shortly
+        if (_reading.count(key) != 0) continue;
+
+        if (previous.count(key) == 0) ++numRequested;
+        _pending.push_back(key);
+    }
+
+    if (!_pending.empty()) _cv.notify_all();
+}
+
+void TilePrefetcher::run()
+{
+    while (true)
+    {
+        TileCache::Key key;
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            _cv.wait(lock, [&]() { return !_active || !_pending.empty(); });
+            if (!_active) return;
+
+            key = _pending.front();
+            _pending.pop_front();
+            _reading.insert(key);
+        }
+
+        numRead += _tileReader->prefetch_subtile(key.x, key.y, key.level, _options);
+
+        std::scoped_lock<std::mutex> lock(_mutex);
+        _reading.erase(key);
+    }
+}
+
+void TilePrefetcher::stop()
+{
+    {
+        std::scoped_lock<std::mutex> lock(_mutex);
+        _active = false;
+    }
+    _cv.notify_all();
+
+    for (auto& thread : threads)
+    {
+        if (thread.joinable()) thread.join();
+    }
+}
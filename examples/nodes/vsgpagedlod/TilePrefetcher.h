@@ -0,0 +1,72 @@
+#pragma once
+
+#include <vsg/all.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <set>
+#include <thread>
+
+#include "TileReader.h"
+
+// TilePrefetcher predicts where the camera will be over the next lookAhead seconds, either by reading ahead along an
+// AnimationPath or by extrapolating the eye point's velocity with the current view direction, and reads the subtiles that
+// the PagedLOD traversal is likely to request there, those within the predicted view frustum, into the TileReader's tileCache. The DatabasePager then finds the images already decoded
+// so fast fly-throughs spend fewer frames displaying coarse tiles while waiting on reads.
+//
+// Prefetching is kept at low priority by using a small number of dedicated threads, by default one, and by replacing
+// the queue of pending prefetches each frame so requests for places the camera is no longer heading are dropped.
+class TilePrefetcher : public vsg::Inherit<vsg::Object, TilePrefetcher>
+{
+public:
+    TilePrefetcher(vsg::ref_ptr<TileReader> in_tileReader, vsg::ref_ptr<const vsg::Options> in_options, uint32_t numThreads = 1);
+
+    double lookAhead = 2.0;   // seconds
+    uint32_t numSamples = 4;  // predicted camera positions over the lookAhead period
+    double lodScale = 3.73;   // projection matrix [1][1], 1/tan(fovy/2), used to match the RecordTraversal's LOD selection
+    size_t maxPending = 64;   // maximum number of subtiles queued for prefetching
+
+    // projection used with the predicted view matrices to cull tiles outside the view frustum, when null tiles in all directions are prefetched
+    vsg::ref_ptr<vsg::ProjectionMatrix> projection;
+
+    // extrapolate from the eye point's motion since the previous update, keeping the current view direction
+    void update(double time, const vsg::LookAt& lookAt);
+
+    // read ahead along the animation path being used to drive the camera
+    void update(double time, const vsg::AnimationPath& path);
+
+    void stop();
+
+    std::atomic<uint64_t> numRequested{0}; // subtiles added to the prefetch queue
+    std::atomic<uint64_t> numDropped{0};   // subtiles removed from the queue before being read as no longer predicted
+    std::atomic<uint64_t> numRead{0};      // images read into the tileCache
+
+    std::vector<std::thread> threads;
+
+protected:
+    virtual ~TilePrefetcher();
+
+    struct View
+    {
+        vsg::dvec3 eye;
+        vsg::dmat4 viewMatrix;
+    };
+
+    void request(const std::vector<View>& views);
+    void run();
+
+    vsg::ref_ptr<TileReader> _tileReader;
+    vsg::ref_ptr<const vsg::Options> _options;
+
+    double _previousTime = 0.0;
+    vsg::dvec3 _previousEye;
+    vsg::dvec3 _velocity;
+    bool _first = true;
+
+    std::mutex _mutex;
+    std::condition_variable _cv;
+    std::deque<TileCache::Key> _pending;
+    std::set<TileCache::Key> _reading;
+    bool _active = true;
+};
@@ -1,4 +1,47 @@
 #include "TileReader.h"
+#include "LocalECEFConverter.h"
+#include "TextureCompression.h"
+#include "TileLoadStats.h"
+#include "TraceEvents.h"
+
+// shaders for TileReader::compactVertices, positions are normalized 0 to 1 within the tile's bounding box and are scaled
+// to the tile's local coordinates by its MatrixTransform
+char compact_tile_vert[] = R"(
+#version 450
+#extension GL_ARB_separate_shader_objects : enable
+
+layout(push_constant) uniform PushConstants {
+    mat4 projection;
+    mat4 modelview;
+} pc;
+
+layout(location = 0) in vec3 inPosition;
+layout(location = 1) in vec2 inTexCoord;
+
+layout(location = 0) out vec2 fragTexCoord;
+
+out gl_PerVertex {
+    vec4 gl_Position;
+};
+
+void main() {
+    gl_Position = (pc.projection * pc.modelview) * vec4(inPosition, 1.0);
+    fragTexCoord = inTexCoord;
+})";
+
+char compact_tile_frag[] = R"(
+#version 450
+#extension GL_ARB_separate_shader_objects : enable
+
+layout(binding = 0) uniform sampler2D texSampler;
+
+layout(location = 0) in vec2 fragTexCoord;
+
+layout(location = 0) out vec4 outColor;
+
+void main() {
+    outColor = texture(texSampler, fragTexCoord);
+})";
 
 vsg::dvec3 TileReader::computeLatitudeLongitudeAltitude(const vsg::dvec3& src) const
 {
@@ -79,6 +122,9 @@ vsg::ref_ptr<vsg::Object> TileReader::read_root(vsg::ref_ptr<const vsg::Options>
 {
     auto group = createRoot();
 
+    // one copy of the options for all the PagedLOD, passed on to their subtiles by read_subtile()
+    auto tileOptions = vsg::Options::create_if(options, *options);
+
     uint32_t lod = 0;
     for (uint32_t y = 0; y < noY; ++y)
     {
@@ -87,7 +133,7 @@ vsg::ref_ptr<vsg::Object> TileReader::read_root(vsg::ref_ptr<const vsg::Options>
             auto imagePath = getTilePath(imageLayer, x, y, lod);
             //auto terrainPath = getTilePath(terrainLayer, x, y, lod);
 
-            auto imageTile = vsg::read_cast<vsg::Data>(imagePath, options);
+            auto imageTile = compressImage(vsg::read_cast<vsg::Data>(imagePath, options));
             //auto terrainTile = vsg::read(terrainPath, options);
 
             if (imageTile)
@@ -96,17 +142,19 @@ vsg::ref_ptr<vsg::Object> TileReader::read_root(vsg::ref_ptr<const vsg::Options>
                 auto tile = createTile(tile_extents, imageTile);
                 if (tile)
                 {
-                    vsg::ComputeBounds computeBound;
-                    tile->accept(computeBound);
-                    auto& bb = computeBound.bounds;
-                    vsg::dsphere bound((bb.min.x + bb.max.x) * 0.5, (bb.min.y + bb.max.y) * 0.5, (bb.min.z + bb.max.z) * 0.5, vsg::length(bb.max - bb.min) * 0.5);
+                    auto bound = computeBound(tile, x, y, lod);
 
                     auto plod = vsg::PagedLOD::create();
                     plod->bound = bound;
                     plod->children[0] = vsg::PagedLOD::Child{0.25, {}};  // external child visible when it's bound occupies more than 1/4 of the height of the window
                     plod->children[1] = vsg::PagedLOD::Child{0.0, tile}; // visible always
                     plod->filename = vsg::make_string(x, " ", y, " 0.tile");
-                    plod->options = vsg::Options::create_if(options, *options);
+                    if (shareTileResources)
+                        plod->options = tileOptions;
+                    else
+                        plod->options = vsg::Options::create_if(options, *options);
+
+                    if (tileInterest) tileInterest->add(plod->filename, plod);
 
                     group->addChild(plod);
                 }
@@ -142,9 +190,34 @@ vsg::ref_ptr<vsg::Object> TileReader::read_subtile(uint32_t x, uint32_t y, uint3
 
     // need to load subtile x y lod
 
+    TRACE_ZONE_CATEGORY("TileReader::read_subtile", "operation");
+
     vsg::time_point start_read = vsg::clock::now();
 
-    auto group = vsg::Group::create();
+    // the token is passed on to the ReaderWriters reading the images via a copy of the options, so they can also abandon the reads
+    auto token = tileInterest ? tileInterest->token(vsg::make_string(x, " ", y, " ", lod, ".tile")) : vsg::ref_ptr<CancellationToken>();
+    auto readOptions = options;
+    if (token && cancelObsoleteLoads)
+    {
+        auto local_options = options ? vsg::Options::create(*options) : vsg::Options::create();
+        local_options->setObject("CancellationToken", token);
+        readOptions = local_options;
+    }
+
+    auto cancelled = [&]() {
+        if (!token || !cancelObsoleteLoads || !token->cancelled()) return false;
+
+        double time = std::chrono::duration<double, std::chrono::milliseconds::period>(vsg::clock::now() - start_read).count();
+
+        std::scoped_lock<std::mutex> lock(statsMutex);
+        numTilesCancelled += 1;
+        timeCancelledReadingTiles += time;
+        return true;
+    };
+
+    if (cancelled()) return {};
+
+    auto group = TileGroup::create();
 
     struct TileID
     {
@@ -154,6 +227,7 @@ vsg::ref_ptr<vsg::Object> TileReader::read_subtile(uint32_t x, uint32_t y, uint3
 
     vsg::Paths tiles;
     std::map<vsg::Path, TileID> pathToTileID;
+    vsg::PathObjects pathObjects;
 
     uint32_t subtile_x = x * 2;
     uint32_t subtile_y = y * 2;
@@ -165,29 +239,65 @@ vsg::ref_ptr<vsg::Object> TileReader::read_subtile(uint32_t x, uint32_t y, uint3
             uint32_t local_x = subtile_x + dx;
             uint32_t local_y = subtile_y + dy;
             auto tilePath = getTilePath(imageLayer, local_x, local_y, local_lod);
-            tiles.push_back(tilePath);
             pathToTileID[tilePath] = TileID{local_x, local_y};
+
+            if (tileCache)
+            {
+                if (auto imageTile = tileCache->get(TileCache::Key{local_x, local_y, local_lod}))
+                {
+                    pathObjects[tilePath] = imageTile;
+                    continue;
+                }
+            }
+
+            tiles.push_back(tilePath);
+        }
+    }
+
+    if (!tiles.empty())
+    {
+        TRACE_ZONE_CATEGORY("read subtiles", "read");
+        auto start_images = vsg::clock::now();
+        auto readObjects = batchReader ? batchReader->read(tiles, readOptions) : vsg::read(tiles, readOptions);
+        TileLoadStats::instance().add(TileLoadStats::READ, start_images, vsg::clock::now());
+        for (auto& [tilePath, object] : readObjects)
+        {
+            // compress before adding to the tileCache so cached images are compressed too
+            auto imageTile = compressImage(object.cast<vsg::Data>());
+            pathObjects[tilePath] = imageTile ? imageTile : object;
+
+            if (imageTile && tileCache)
+            {
+                auto& tileID = pathToTileID[tilePath];
+                tileCache->insert(TileCache::Key{tileID.local_x, tileID.local_y, local_lod}, imageTile);
+            }
         }
     }
 
-    auto pathObjects = vsg::read(tiles, options);
+    // images that were read are kept in the tileCache so aren't wasted if the camera returns
+    if (cancelled()) return {};
 
     if (pathObjects.size() == 4)
     {
         for (auto& [tilePath, object] : pathObjects)
         {
+            if (cancelled()) return {};
+
             auto& tileID = pathToTileID[tilePath];
             auto imageTile = object.cast<vsg::Data>();
             if (imageTile)
             {
+                TRACE_ZONE_CATEGORY("createTile", "build");
+
+                auto start_mesh = vsg::clock::now();
                 auto tile_extents = computeTileExtents(tileID.local_x, tileID.local_y, local_lod);
                 auto tile = createTile(tile_extents, imageTile);
+                auto start_bound = vsg::clock::now();
+                TileLoadStats::instance().add(TileLoadStats::MESH, start_mesh, start_bound);
                 if (tile)
                 {
-                    vsg::ComputeBounds computeBound;
-                    tile->accept(computeBound);
-                    auto& bb = computeBound.bounds;
-                    vsg::dsphere bound((bb.min.x + bb.max.x) * 0.5, (bb.min.y + bb.max.y) * 0.5, (bb.min.z + bb.max.z) * 0.5, vsg::length(bb.max - bb.min) * 0.5);
+                    auto bound = computeBound(tile, tileID.local_x, tileID.local_y, local_lod);
+                    TileLoadStats::instance().add(TileLoadStats::BOUND, start_bound, vsg::clock::now());
 
                     if (local_lod < maxLevel)
                     {
@@ -196,7 +306,12 @@ vsg::ref_ptr<vsg::Object> TileReader::read_subtile(uint32_t x, uint32_t y, uint3
                         plod->children[0] = vsg::PagedLOD::Child{lodTransitionScreenHeightRatio, {}}; // external child visible when it's bound occupies more than 1/4 of the height of the window
                         plod->children[1] = vsg::PagedLOD::Child{0.0, tile};                          // visible always
                         plod->filename = vsg::make_string(tileID.local_x, " ", tileID.local_y, " ", local_lod, ".tile");
-                        plod->options = vsg::Options::create_if(options, *options);
+                        if (shareTileResources)
+                            plod->options = options;
+                        else
+                            plod->options = vsg::Options::create_if(options, *options);
+
+                        if (tileInterest) tileInterest->add(plod->filename, plod);
 
                         //std::cout<<"plod->filename "<<plod->filename<<std::endl;
 
@@ -215,6 +330,9 @@ vsg::ref_ptr<vsg::Object> TileReader::read_subtile(uint32_t x, uint32_t y, uint3
         }
     }
 
+    // skip the compile and merge of the subtiles if they are no longer needed
+    if (cancelled()) return {};
+
     vsg::time_point end_read = vsg::clock::now();
 
     double time_to_read_tile = std::chrono::duration<float, std::chrono::milliseconds::period>(end_read - start_read).count();
@@ -223,6 +341,12 @@ vsg::ref_ptr<vsg::Object> TileReader::read_subtile(uint32_t x, uint32_t y, uint3
         std::scoped_lock<std::mutex> lock(statsMutex);
         numTilesRead += 1;
         totalTimeReadingTiles += time_to_read_tile;
+
+        if (token && token->cancelled())
+        {
+            numWastedTileBuilds += 1;
+            timeWastedTileBuilds += time_to_read_tile;
+        }
     }
 
     if (group->children.size() != 4)
@@ -232,9 +356,157 @@ vsg::ref_ptr<vsg::Object> TileReader::read_subtile(uint32_t x, uint32_t y, uint3
         return {};
     }
 
+    TileLoadStats::instance().add(TileLoadStats::SUBTILE, start_read, end_read);
+    group->readCompleted = end_read;
+
+    if (memoryBudget)
+    {
+        group->filename = vsg::make_string(x, " ", y, " ", lod, ".subtile");
+        group->memoryBudget = memoryBudget;
+        computeTileMemory(*group, group->cpuBytes, group->gpuBytes);
+    }
+
     return group;
 }
 
+vsg::ref_ptr<vsg::Data> TileReader::compressImage(vsg::ref_ptr<vsg::Data> image) const
+{
+    if (!compressTextures || !image) return image;
+
+    auto start = vsg::clock::now();
+    auto compressed = compressBC1(*image);
+
+    // leave images that can't be compressed, such as ones that are already compressed, as they are. Only the first is
+    // warned about, the rest are counted for the exit report.
+    if (!compressed)
+    {
+        std::scoped_lock<std::mutex> lock(statsMutex);
+        if (numImagesNotCompressed++ == 0) vsg::warn("TileReader::compressImage() can't compress image with format = ", image->properties.format, ", dimensions = ", image->width(), "x", image->height(), ", leaving it uncompressed.");
+        return image;
+    }
+
+    TileLoadStats::instance().add(TileLoadStats::ENCODE, start, vsg::clock::now());
+    {
+        std::scoped_lock<std::mutex> lock(statsMutex);
+        ++numImagesCompressed;
+    }
+    return compressed;
+}
+
+vsg::dsphere TileReader::computeTileBound(uint32_t x, uint32_t y, uint32_t level) const
+{
+    auto tile_extents = computeTileExtents(x, y, level);
+
+    auto toECEF = [&](double longitude, double latitude) {
+        return ellipsoidModel->convertLatLongAltitudeToECEF(computeLatitudeLongitudeAltitude(vsg::dvec3(longitude, latitude, 0.0)));
+    };
+
+    double mid_x = (tile_extents.min.x + tile_extents.max.x) * 0.5;
+    double mid_y = (tile_extents.min.y + tile_extents.max.y) * 0.5;
+    vsg::dvec3 center = toECEF(mid_x, mid_y);
+
+    // corners and edge midpoints, the latter to account for the curvature of large tiles
+    double radius = 0.0;
+    for (double lon : {tile_extents.min.x, mid_x, tile_extents.max.x})
+    {
+        for (double lat : {tile_extents.min.y, mid_y, tile_extents.max.y})
+        {
+            radius = std::max(radius, vsg::length(toECEF(lon, lat) - center));
+        }
+    }
+
+    return vsg::dsphere(center, radius);
+}
+
+vsg::dsphere TileReader::computeBound(vsg::ref_ptr<vsg::Node> tile, uint32_t x, uint32_t y, uint32_t level) const
+{
+    // ComputeBounds only handles float vertex arrays so can't compute the bounds of compact tiles, use their extents instead
+    if (compactVertices) return computeTileBound(x, y, level);
+
+    vsg::ComputeBounds computeBounds;
+    tile->accept(computeBounds);
+    auto& bb = computeBounds.bounds;
+    return vsg::dsphere((bb.min.x + bb.max.x) * 0.5, (bb.min.y + bb.max.y) * 0.5, (bb.min.z + bb.max.z) * 0.5, vsg::length(bb.max - bb.min) * 0.5);
+}
+
+void TileReader::computeTileMemory(const vsg::Node& node, size_t& cpuBytes, size_t& gpuBytes) const
+{
+    auto collect = CollectTileMemory::create();
+    node.accept(*collect);
+
+    size_t geometrySize = 0;
+    for (auto& data : collect->geometry)
+    {
+        if (sharedData.count(data) == 0) geometrySize += data->dataSize();
+    }
+
+    size_t imageSize = 0;
+    size_t mipmapSize = 0;
+    for (auto& data : collect->images)
+    {
+        imageSize += data->dataSize();
+
+        // the GPU generates the mipmaps of images that don't provide their own, adding a third to the image
+        if (mipmapLevelsHint > 1 && data->properties.maxNumMipmaps <= 1) mipmapSize += data->dataSize() / 3;
+    }
+
+    cpuBytes = geometrySize + imageSize;
+    gpuBytes = geometrySize + imageSize + mipmapSize;
+}
+
+bool TileReader::subtileCached(uint32_t x, uint32_t y, uint32_t lod) const
+{
+    if (!tileCache) return false;
+
+    for (uint32_t dy = 0; dy < 2; ++dy)
+    {
+        for (uint32_t dx = 0; dx < 2; ++dx)
+        {
+            if (!tileCache->contains(TileCache::Key{x * 2 + dx, y * 2 + dy, lod + 1})) return false;
+        }
+    }
+    return true;
+}
+
+uint32_t TileReader::prefetch_subtile(uint32_t x, uint32_t y, uint32_t lod, vsg::ref_ptr<const vsg::Options> options) const
+{
+    if (!tileCache) return 0;
+
+    TRACE_ZONE_CATEGORY("TileReader::prefetch_subtile", "prefetch");
+
+    vsg::Paths tiles;
+    std::map<vsg::Path, TileCache::Key> pathToKey;
+
+    uint32_t local_lod = lod + 1;
+    for (uint32_t dy = 0; dy < 2; ++dy)
+    {
+        for (uint32_t dx = 0; dx < 2; ++dx)
+        {
+            TileCache::Key key{x * 2 + dx, y * 2 + dy, local_lod};
+            if (tileCache->contains(key)) continue;
+
+            auto tilePath = getTilePath(imageLayer, key.x, key.y, key.level);
+            tiles.push_back(tilePath);
+            pathToKey[tilePath] = key;
+        }
+    }
+
+    if (tiles.empty()) return 0;
+
+    uint32_t numRead = 0;
+    auto readObjects = batchReader ? batchReader->read(tiles, options) : vsg::read(tiles, options);
+    for (auto& [tilePath, object] : readObjects)
+    {
+        if (auto imageTile = compressImage(object.cast<vsg::Data>()))
+        {
+            tileCache->insert(pathToKey[tilePath], imageTile, true);
+            ++numRead;
+        }
+    }
+
+    return numRead;
+}
+
 void TileReader::init()
 {
     // set up graphics pipeline
@@ -257,6 +529,23 @@ void TileReader::init()
     sampler->addressModeW = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
     sampler->anisotropyEnable = VK_TRUE;
     sampler->maxAnisotropy = 16.0f;
+
+    if (shareTileResources)
+    {
+        // every ECEF tile uses the same grid topology, white colours and tex coords, so create them once and share the
+        // vsg::Commands between tiles so that the CPU arrays and the GPU buffers created when compiling are shared too.
+        sharedAttributesBottomLeft = vsg::BindVertexBuffers::create(1, createGridAttributes(false));
+        sharedAttributesTopLeft = vsg::BindVertexBuffers::create(1, createGridAttributes(true));
+
+        auto indices = createGridIndices();
+        sharedBindIndexBuffer = vsg::BindIndexBuffer::create(indices);
+        sharedDrawIndexed = vsg::DrawIndexed::create(indices->size(), 1, 0, 0, 0);
+
+        // excluded from the memory of each subtile as it's resident for as long as the TileReader
+        for (auto& array : sharedAttributesBottomLeft->arrays) sharedData.insert(array->data.get());
+        for (auto& array : sharedAttributesTopLeft->arrays) sharedData.insert(array->data.get());
+        sharedData.insert(indices.get());
+    }
 }
 
 vsg::ref_ptr<vsg::StateGroup> TileReader::createRoot() const
@@ -265,8 +554,19 @@ vsg::ref_ptr<vsg::StateGroup> TileReader::createRoot() const
     vsg::Paths searchPaths = vsg::getEnvPaths("VSG_FILE_PATH");
 
     // load shaders
-    vsg::ref_ptr<vsg::ShaderStage> vertexShader = vsg::ShaderStage::read(VK_SHADER_STAGE_VERTEX_BIT, "main", vsg::findFile("shaders/vert_PushConstants.spv", searchPaths));
-    vsg::ref_ptr<vsg::ShaderStage> fragmentShader = vsg::ShaderStage::read(VK_SHADER_STAGE_FRAGMENT_BIT, "main", vsg::findFile("shaders/frag_PushConstants.spv", searchPaths));
+    vsg::ref_ptr<vsg::ShaderStage> vertexShader;
+    vsg::ref_ptr<vsg::ShaderStage> fragmentShader;
+    if (compactVertices)
+    {
+        vertexShader = vsg::ShaderStage::create(VK_SHADER_STAGE_VERTEX_BIT, "main", compact_tile_vert);
+        fragmentShader = vsg::ShaderStage::create(VK_SHADER_STAGE_FRAGMENT_BIT, "main", compact_tile_frag);
+    }
+    else
+    {
+        vertexShader = vsg::ShaderStage::read(VK_SHADER_STAGE_VERTEX_BIT, "main", vsg::findFile("shaders/vert_PushConstants.spv", searchPaths));
+        fragmentShader = vsg::ShaderStage::read(VK_SHADER_STAGE_FRAGMENT_BIT, "main", vsg::findFile("shaders/frag_PushConstants.spv", searchPaths));
+    }
+
     if (!vertexShader || !fragmentShader)
     {
         vsg::warn("Could not create shaders.");
@@ -285,6 +585,20 @@ vsg::ref_ptr<vsg::StateGroup> TileReader::createRoot() const
         VkVertexInputAttributeDescription{2, 2, VK_FORMAT_R32G32_SFLOAT, 0},    // tex coord data
     };
 
+    if (compactVertices)
+    {
+        // 8 byte quantized positions, 4 byte tex coords and no colours, versus 32 bytes per vertex
+        vertexBindingsDescriptions = {
+            VkVertexInputBindingDescription{0, sizeof(vsg::usvec4), VK_VERTEX_INPUT_RATE_VERTEX}, // vertex data
+            VkVertexInputBindingDescription{1, sizeof(vsg::usvec2), VK_VERTEX_INPUT_RATE_VERTEX}  // tex coord data
+        };
+
+        vertexAttributeDescriptions = {
+            VkVertexInputAttributeDescription{0, 0, VK_FORMAT_R16G16B16A16_UNORM, 0}, // vertex data
+            VkVertexInputAttributeDescription{1, 1, VK_FORMAT_R16G16_UNORM, 0},       // tex coord data
+        };
+    }
+
     vsg::GraphicsPipelineStates pipelineStates{
         vsg::VertexInputState::create(vertexBindingsDescriptions, vertexAttributeDescriptions),
         vsg::InputAssemblyState::create(),
@@ -311,6 +625,68 @@ vsg::ref_ptr<vsg::Node> TileReader::createTile(const vsg::dbox& tile_extents, vs
 #endif
 }
 
+vsg::DataList TileReader::createGridAttributes(bool topLeft) const
+{
+    uint32_t numVertices = numRows * numCols;
+
+    float sCoordScale = 1.0f / float(numCols - 1);
+    float tCoordScale = 1.0f / float(numRows - 1);
+    float tCoordOrigin = 0.0;
+    if (topLeft)
+    {
+        tCoordScale = -tCoordScale;
+        tCoordOrigin = 1.0f;
+    }
+
+    if (compactVertices)
+    {
+        // 16 bit normalized tex coords and no colours, the compact shaders use white
+        auto texcoords = vsg::usvec2Array::create(numVertices);
+        for (uint32_t r = 0; r < numRows; ++r)
+        {
+            for (uint32_t c = 0; c < numCols; ++c)
+            {
+                vsg::vec2 texcoord(float(c) * sCoordScale, tCoordOrigin + float(r) * tCoordScale);
+                texcoords->set(c + r * numCols, vsg::usvec2(static_cast<uint16_t>(std::lround(texcoord.x * 65535.0f)), static_cast<uint16_t>(std::lround(texcoord.y * 65535.0f))));
+            }
+        }
+        return vsg::DataList{texcoords};
+    }
+
+    auto colors = vsg::vec3Array::create(numVertices, vsg::vec3(1.0f, 1.0f, 1.0f));
+    auto texcoords = vsg::vec2Array::create(numVertices);
+    for (uint32_t r = 0; r < numRows; ++r)
+    {
+        for (uint32_t c = 0; c < numCols; ++c)
+        {
+            texcoords->set(c + r * numCols, vsg::vec2(float(c) * sCoordScale, tCoordOrigin + float(r) * tCoordScale));
+        }
+    }
+    return vsg::DataList{colors, texcoords};
+}
+
+vsg::ref_ptr<vsg::ushortArray> TileReader::createGridIndices() const
+{
+    uint32_t numTriangles = (numRows - 1) * (numCols - 1) * 2;
+
+    auto indices = vsg::ushortArray::create(numTriangles * 3);
+    auto itr = indices->begin();
+    for (uint32_t r = 0; r < numRows - 1; ++r)
+    {
+        for (uint32_t c = 0; c < numCols - 1; ++c)
+        {
+            uint32_t vi = c + r * numCols;
+            (*itr++) = vi;
+            (*itr++) = vi + 1;
+            (*itr++) = vi + numCols;
+            (*itr++) = vi + numCols;
+            (*itr++) = vi + 1;
+            (*itr++) = vi + numCols + 1;
+        }
+    }
+    return indices;
+}
+
 vsg::ref_ptr<vsg::Node> TileReader::createECEFTile(const vsg::dbox& tile_extents, vsg::ref_ptr<vsg::Data> textureData) const
 {
     vsg::dvec3 center = computeLatitudeLongitudeAltitude((tile_extents.min + tile_extents.max) * 0.5);
@@ -334,71 +710,77 @@ vsg::ref_ptr<vsg::Node> TileReader::createECEFTile(const vsg::dbox& tile_extents
     // add transform to root of the scene graph
     scenegraph->addChild(transform);
 
-    uint32_t numRows = 32;
-    uint32_t numCols = 32;
     uint32_t numVertices = numRows * numCols;
-    uint32_t numTriangles = (numRows - 1) * (numCols - 1) * 2;
 
     double longitudeOrigin = tile_extents.min.x;
     double longitudeScale = (tile_extents.max.x - tile_extents.min.x) / double(numCols - 1);
     double latitudeOrigin = tile_extents.min.y;
     double latitudeScale = (tile_extents.max.y - tile_extents.min.y) / double(numRows - 1);
 
-    float sCoordScale = 1.0f / float(numCols - 1);
-    float tCoordScale = 1.0f / float(numRows - 1);
-    float tCoordOrigin = 0.0;
-    if (textureData->properties.origin == vsg::TOP_LEFT)
+    // the projection maps rows to latitudes and columns to longitudes, so the grid can be converted to ECEF as a batch
+    std::vector<double> latitudes(numRows);
+    std::vector<double> longitudes(numCols);
+    for (uint32_t r = 0; r < numRows; ++r)
     {
-        tCoordScale = -tCoordScale;
-        tCoordOrigin = 1.0f;
+        latitudes[r] = computeLatitudeLongitudeAltitude(vsg::dvec3(longitudeOrigin, latitudeOrigin + double(r) * latitudeScale, 0.0)).x;
+    }
+    for (uint32_t c = 0; c < numCols; ++c)
+    {
+        longitudes[c] = computeLatitudeLongitudeAltitude(vsg::dvec3(longitudeOrigin + double(c) * longitudeScale, latitudeOrigin, 0.0)).y;
     }
-
-    vsg::vec3 color(1.0f, 1.0f, 1.0f);
 
     // set up vertex coords
     auto vertices = vsg::vec3Array::create(numVertices);
-    auto colors = vsg::vec3Array::create(numVertices);
-    auto texcoords = vsg::vec2Array::create(numVertices);
-    for (uint32_t r = 0; r < numRows; ++r)
+    LocalECEFConverter converter(*ellipsoidModel, worldToLocal);
+    converter.convertGrid(latitudes.data(), numRows, longitudes.data(), numCols, 0.0, vertices->data());
+
+    vsg::ref_ptr<vsg::Data> positions = vertices;
+    if (compactVertices)
     {
-        for (uint32_t c = 0; c < numCols; ++c)
+        // quantize the vertices to 16 bits relative to the tile's local bounding box, the dequantizing scale and offset
+        // are folded into the tile's transform so the shader reads the normalized positions as they are.
+        vsg::vec3 min_v = vertices->at(0);
+        vsg::vec3 max_v = vertices->at(0);
+        for (auto& v : *vertices)
         {
-            vsg::dvec3 location(longitudeOrigin + double(c) * longitudeScale, latitudeOrigin + double(r) * latitudeScale, 0.0);
-            vsg::dvec3 latitudeLongitudeAltitude = computeLatitudeLongitudeAltitude(location);
-
-            auto ecef = ellipsoidModel->convertLatLongAltitudeToECEF(latitudeLongitudeAltitude);
-            vsg::vec3 vertex(worldToLocal * ecef);
-            vsg::vec2 texcoord(float(c) * sCoordScale, tCoordOrigin + float(r) * tCoordScale);
-
-            uint32_t vi = c + r * numCols;
-            vertices->set(vi, vertex);
-            colors->set(vi, color);
-            texcoords->set(vi, texcoord);
+            min_v.set(std::min(min_v.x, v.x), std::min(min_v.y, v.y), std::min(min_v.z, v.z));
+            max_v.set(std::max(max_v.x, v.x), std::max(max_v.y, v.y), std::max(max_v.z, v.z));
         }
-    }
 
-    // set up indices
-    auto indices = vsg::ushortArray::create(numTriangles * 3);
-    auto itr = indices->begin();
-    for (uint32_t r = 0; r < numRows - 1; ++r)
-    {
-        for (uint32_t c = 0; c < numCols - 1; ++c)
+        vsg::vec3 extent(std::max(max_v.x - min_v.x, 1e-3f), std::max(max_v.y - min_v.y, 1e-3f), std::max(max_v.z - min_v.z, 1e-3f));
+        auto quantize = [](float value, float origin, float range) { return static_cast<uint16_t>(std::lround((value - origin) / range * 65535.0f)); };
+
+        auto quantized = vsg::usvec4Array::create(numVertices);
+        for (uint32_t i = 0; i < numVertices; ++i)
         {
-            uint32_t vi = c + r * numCols;
-            (*itr++) = vi;
-            (*itr++) = vi + 1;
-            (*itr++) = vi + numCols;
-            (*itr++) = vi + numCols;
-            (*itr++) = vi + 1;
-            (*itr++) = vi + numCols + 1;
+            auto& v = vertices->at(i);
+            quantized->set(i, vsg::usvec4(quantize(v.x, min_v.x, extent.x), quantize(v.y, min_v.y, extent.y), quantize(v.z, min_v.z, extent.z), 0));
         }
+        positions = quantized;
+
+        transform->matrix = localToWorld * vsg::translate(vsg::dvec3(min_v)) * vsg::scale(vsg::dvec3(extent));
     }
 
+    bool topLeft = textureData->properties.origin == vsg::TOP_LEFT;
+
     // setup geometry
     auto drawCommands = vsg::Commands::create();
-    drawCommands->addChild(vsg::BindVertexBuffers::create(0, vsg::DataList{vertices, colors, texcoords}));
-    drawCommands->addChild(vsg::BindIndexBuffer::create(indices));
-    drawCommands->addChild(vsg::DrawIndexed::create(indices->size(), 1, 0, 0, 0));
+    drawCommands->addChild(vsg::BindVertexBuffers::create(0, vsg::DataList{positions}));
+    if (shareTileResources)
+    {
+        // only the vertices are unique to this tile, the rest is shared with all other tiles
+        drawCommands->addChild(topLeft ? sharedAttributesTopLeft : sharedAttributesBottomLeft);
+        drawCommands->addChild(sharedBindIndexBuffer);
+        drawCommands->addChild(sharedDrawIndexed);
+    }
+    else
+    {
+        auto indices = createGridIndices();
+
+        drawCommands->addChild(vsg::BindVertexBuffers::create(1, createGridAttributes(topLeft)));
+        drawCommands->addChild(vsg::BindIndexBuffer::create(indices));
+        drawCommands->addChild(vsg::DrawIndexed::create(indices->size(), 1, 0, 0, 0));
+    }
 
     // add drawCommands to transform
     transform->addChild(drawCommands);
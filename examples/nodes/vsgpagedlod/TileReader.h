@@ -2,6 +2,11 @@
 
 #include <vsg/all.h>
 
+#include "BatchReader.h"
+#include "TileCache.h"
+#include "TileInterest.h"
+#include "TileMemory.h"
+
 class TileReader : public vsg::Inherit<vsg::ReaderWriter, TileReader>
 {
 public:
@@ -20,14 +25,53 @@ public:
     vsg::Path terrainLayer;
     uint32_t mipmapLevelsHint = 16;
 
+    // share the tile grid's indices, colours and tex coords, and the PagedLOD's Options, between all tiles rather than each tile having its own copy.
+    bool shareTileResources = true;
+
+    // use 16 bit quantized positions and tex coords, and no colours, so tiles have 12 bytes per vertex rather than 32.
+    bool compactVertices = false;
+
+    // compress image tiles to BC1, with mipmaps generated on the CPU, on the loading threads. 8x less GPU memory and upload than RGBA8.
+    bool compressTextures = false;
+
+    // optional reader used to read the 4 images of each subtile as a single batch, when null vsg::read(paths, options) is used.
+    vsg::ref_ptr<BatchReader> batchReader;
+
+    // optional cache of decoded image tiles, checked before reading each subtile's images.
+    vsg::ref_ptr<TileCache> tileCache;
+
+    // optional tracking of the memory used by the loaded subtiles.
+    vsg::ref_ptr<TileMemoryBudget> memoryBudget;
+
+    // optional tracking of the PagedLOD created for each tile, used to detect loads the camera no longer needs.
+    vsg::ref_ptr<TileInterest> tileInterest;
+
+    // abandon loads between reading and building the subtiles once the requesting PagedLOD is no longer required, requires tileInterest.
+    bool cancelObsoleteLoads = false;
+
     void init();
 
     vsg::ref_ptr<vsg::Object> read(const vsg::Path& filename, vsg::ref_ptr<const vsg::Options> options = {}) const override;
 
+    // bounding sphere of tile x y level in ECEF coordinates, the same as used for its PagedLOD.
+    vsg::dsphere computeTileBound(uint32_t x, uint32_t y, uint32_t level) const;
+
+    // return true if all 4 images of the subtile of x y lod are in the tileCache.
+    bool subtileCached(uint32_t x, uint32_t y, uint32_t lod) const;
+
+    // read the images of the subtile of x y lod into the tileCache ahead of the DatabasePager requesting it, returns the number of images read.
+    uint32_t prefetch_subtile(uint32_t x, uint32_t y, uint32_t lod, vsg::ref_ptr<const vsg::Options> options = {}) const;
+
     // timing stats
     mutable std::mutex statsMutex;
     mutable uint64_t numTilesRead{0};
     mutable double totalTimeReadingTiles{0.0};
+    mutable uint64_t numTilesCancelled{0};
+    mutable double timeCancelledReadingTiles{0.0}; // time spent on loads before they were cancelled
+    mutable uint64_t numWastedTileBuilds{0};       // subtiles completed after the requesting PagedLOD was no longer required
+    mutable double timeWastedTileBuilds{0.0};
+    mutable uint64_t numImagesCompressed{0};
+    mutable uint64_t numImagesNotCompressed{0}; // images left as they were as compressBC1 doesn't support their format or dimensions
 
 protected:
     vsg::dvec3 computeLatitudeLongitudeAltitude(const vsg::dvec3& src) const;
@@ -41,9 +85,30 @@ protected:
     vsg::ref_ptr<vsg::Node> createECEFTile(const vsg::dbox& tile_extents, vsg::ref_ptr<vsg::Data> sourceData) const;
     vsg::ref_ptr<vsg::Node> createTextureQuad(const vsg::dbox& tile_extents, vsg::ref_ptr<vsg::Data> sourceData) const;
 
+    vsg::dsphere computeBound(vsg::ref_ptr<vsg::Node> tile, uint32_t x, uint32_t y, uint32_t level) const;
+
+    vsg::ref_ptr<vsg::Data> compressImage(vsg::ref_ptr<vsg::Data> image) const;
+
+    // compute the CPU and GPU memory used by a subtile, excluding the data shared between all tiles.
+    void computeTileMemory(const vsg::Node& node, size_t& cpuBytes, size_t& gpuBytes) const;
+
+    vsg::DataList createGridAttributes(bool topLeft) const;
+    vsg::ref_ptr<vsg::ushortArray> createGridIndices() const;
+
     vsg::ref_ptr<vsg::StateGroup> createRoot() const;
 
     vsg::ref_ptr<vsg::DescriptorSetLayout> descriptorSetLayout;
     vsg::ref_ptr<vsg::PipelineLayout> pipelineLayout;
     vsg::ref_ptr<vsg::Sampler> sampler;
+
+    // dimensions of the ECEF tile grid
+    uint32_t numRows = 32;
+    uint32_t numCols = 32;
+
+    // commands shared by all ECEF tiles when shareTileResources is set, assigned by init(), the attributes bind the vertex arrays after the positions
+    vsg::ref_ptr<vsg::BindVertexBuffers> sharedAttributesBottomLeft;
+    vsg::ref_ptr<vsg::BindVertexBuffers> sharedAttributesTopLeft;
+    vsg::ref_ptr<vsg::BindIndexBuffer> sharedBindIndexBuffer;
+    vsg::ref_ptr<vsg::DrawIndexed> sharedDrawIndexed;
+    std::set<const vsg::Data*> sharedData;
 };
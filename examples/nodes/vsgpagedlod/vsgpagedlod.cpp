@@ -4,10 +4,46 @@
 
 #include <algorithm>
 #include <chrono>
+#include <fstream>
 #include <iostream>
 #include <thread>
 
+#include "DiskTileCache.h"
+#include "LocalECEFConverter.h"
+#include "ParallelLoadPagedLOD.h"
+#include "SimulatedTileServer.h"
+#include "TileLoadStats.h"
+#include "TileMemory.h"
+#include "TilePack.h"
+#include "TilePrefetcher.h"
 #include "TileReader.h"
+#include "TraceEvents.h"
+
+// print the tile load stage timings on pressing 's' so they can be checked while flying around.
+class TileLoadStatsHandler : public vsg::Inherit<vsg::Visitor, TileLoadStatsHandler>
+{
+public:
+    void apply(vsg::KeyPressEvent& keyPress) override
+    {
+        if (keyPress.keyBase == 's') TileLoadStats::instance().report(std::cout);
+    }
+};
+
+// resident set size of the process in bytes, or its peak with field = "VmHWM:", or 0 where it can't be determined.
+size_t processResidentMemory(const std::string& field = "VmRSS:")
+{
+#if defined(__linux__)
+    std::ifstream fin("/proc/self/status");
+    std::string line;
+    while (std::getline(fin, line))
+    {
+        if (line.compare(0, field.size(), field) == 0) return static_cast<size_t>(std::stoul(line.substr(field.size()))) * 1024;
+    }
+#else
+    (void)field;
+#endif
+    return 0;
+}
 
 int main(int argc, char** argv)
 {
@@ -45,16 +81,70 @@ int main(int argc, char** argv)
         auto numFrames = arguments.value(-1, "-f");
         auto pathFilename = arguments.value(std::string(), "-p");
         auto maxPagedLOD = arguments.value(0, "--maxPagedLOD");
+        auto maxMemory = arguments.value<size_t>(0, "--max-memory");
         auto loadLevels = arguments.value(0, "--load-levels");
+        auto numLoadThreads = arguments.value(0u, "--load-threads");
         auto horizonMountainHeight = arguments.value(0.0, "--hmh");
         bool useEllipsoidPerspective = !arguments.read({"--disble-EllipsoidPerspective", "--dep"});
         if (arguments.read("--rgb")) options->mapRGBtoRGBAHint = false;
         arguments.read("--file-cache", options->fileCache);
+        auto fileCacheSize = arguments.value<size_t>(0, "--file-cache-size");
+        bool fileCacheLFU = arguments.read("--file-cache-lfu");
         bool osgEarthStyleMouseButtons = arguments.read({"--osgearth", "-e"});
 
         uint32_t numOperationThreads = 0;
         if (arguments.read("--ot", numOperationThreads)) options->operationThreads = vsg::OperationThreads::create(numOperationThreads);
 
+        uint32_t numBatchReadThreads = 0;
+        if (arguments.read("--batch-read", numBatchReadThreads)) tileReader->batchReader = BatchReader::create(numBatchReadThreads);
+        if (arguments.read("--no-io-uring") && tileReader->batchReader) tileReader->batchReader->backend = BatchReader::THREAD_POOL;
+        auto readBenchmarkLevel = arguments.value(-1, "--read-benchmark");
+        auto ecefBenchmarkTiles = arguments.value(0u, "--ecef-benchmark");
+        if (size_t tileCacheSize = 0; arguments.read("--tile-cache", tileCacheSize)) tileReader->tileCache = TileCache::create(tileCacheSize * 1024 * 1024);
+        auto prefetchTime = arguments.value(0.0, "--prefetch");
+        auto numPrefetchThreads = arguments.value<uint32_t>(1, "--prefetch-threads");
+        if (arguments.read("--no-shared-tiles")) tileReader->shareTileResources = false;
+        if (arguments.read("--compact")) tileReader->compactVertices = true;
+        if (arguments.read("--bc1"))
+        {
+            // BC compressed formats are an optional device feature
+            tileReader->compressTextures = true;
+            if (!windowTraits->deviceFeatures)
+            {
+                windowTraits->deviceFeatures = vsg::DeviceFeatures::create();
+                windowTraits->deviceFeatures->get().samplerAnisotropy = VK_TRUE;
+            }
+            windowTraits->deviceFeatures->get().textureCompressionBC = VK_TRUE;
+        }
+        if (arguments.read("--cancel")) tileReader->cancelObsoleteLoads = true;
+        auto imageLayer = arguments.value(std::string(), "--image");
+        auto packFilename = arguments.value(vsg::Path(), "--pack");
+        bool simulateServer = arguments.read("--sim");
+        auto simLatency = arguments.value(50.0, "--sim-latency");
+        auto simJitter = arguments.value(25.0, "--sim-jitter");
+        auto simBandwidth = arguments.value(0.0, "--sim-bandwidth");
+        auto simErrorRate = arguments.value(0.0, "--sim-error-rate");
+        auto simTileSize = arguments.value<uint32_t>(256, "--sim-tile-size");
+        bool benchmark = arguments.read("--benchmark");
+        auto traceFilename = arguments.value(vsg::Path(), "--trace");
+        if (traceFilename && !TRACE_ENABLED) std::cout << "Warning: --trace requires building with VSGEXAMPLES_TRACE enabled." << std::endl;
+        TraceEvents::instance().enabled = traceFilename && TRACE_ENABLED;
+
+        if (traceFilename && TRACE_ENABLED)
+        {
+            // record the image reads done by vsg::read(paths, options), including those on the --ot OperationThreads
+            options->readerWriters.insert(options->readerWriters.begin(), TraceReaderWriter::create());
+
+            TraceEvents::instance().setThreadName(std::this_thread::get_id(), "main");
+            if (options->operationThreads)
+            {
+                for (size_t i = 0; i < options->operationThreads->threads.size(); ++i)
+                {
+                    TraceEvents::instance().setThreadName(options->operationThreads->threads[i].get_id(), vsg::make_string("operation thread ", i));
+                }
+            }
+        }
+
         if (arguments.read("--osm"))
         {
             // setup OpenStreetMap settings
@@ -77,6 +167,76 @@ int main(int argc, char** argv)
             // tileReader->terrainLayer = "http://readymap.org/readymap/tiles/1.0.0/116/{z}/{x}/{y}.tif";
         }
 
+        // local or remote image tiles using the same tiling scheme as the above, i.e. --image /data/readymap/{z}/{x}/{y}.jpeg
+        if (!imageLayer.empty()) tileReader->imageLayer = imageLayer;
+
+        // image tiles from a single file written by vsgtilepack, in place of a remote or directory based imageLayer
+        vsg::ref_ptr<TilePackReader> tilePack;
+        if (packFilename)
+        {
+            tilePack = TilePackReader::create(packFilename);
+            if (!tilePack->valid())
+            {
+                std::cout << "Unable to read tile pack " << packFilename << std::endl;
+                return 1;
+            }
+
+            options->readerWriters.insert(options->readerWriters.begin(), tilePack);
+            tileReader->noX = tilePack->header().noX;
+            tileReader->noY = tilePack->header().noY;
+            tileReader->maxLevel = tilePack->header().maxLevel;
+            tileReader->imageLayer = tilePack->tilePathTemplate();
+
+            if (tileReader->batchReader)
+            {
+                std::cout << "Warning: --batch-read reads tile files directly so is disabled when using --pack." << std::endl;
+                tileReader->batchReader = {};
+            }
+        }
+
+        // serve the tiles from an in-process stand-in for a tile server, with simulated latency, bandwidth and errors,
+        // so that paging can be benchmarked reproducibly offline. Tiles come from the --pack when specified, otherwise they are generated.
+        vsg::ref_ptr<SimulatedTileServer> tileServer;
+        if (simulateServer)
+        {
+            tileServer = SimulatedTileServer::create();
+            tileServer->latency = simLatency / 1000.0;
+            tileServer->latencyJitter = simJitter / 1000.0;
+            tileServer->bandwidth = simBandwidth * 1000000.0 / 8.0;
+            tileServer->errorRate = simErrorRate;
+            tileServer->tileSize = simTileSize;
+            tileServer->source = tilePack;
+
+            options->readerWriters.insert(options->readerWriters.begin(), tileServer);
+            tileReader->imageLayer = tileServer->tilePathTemplate();
+
+            if (tileReader->batchReader)
+            {
+                std::cout << "Warning: --batch-read reads tile files directly so is disabled when using --sim." << std::endl;
+                tileReader->batchReader = {};
+            }
+        }
+
+        // manage the fileCache, limiting it to --file-cache-size MB by evicting the least recently used tiles, or with --file-cache-lfu
+        // the least frequently used. The DiskTileCache wraps all the ReaderWriters so it's the only one to write to the fileCache.
+        vsg::ref_ptr<DiskTileCache> diskTileCache;
+        if (fileCacheSize > 0 && options->fileCache)
+        {
+            diskTileCache = DiskTileCache::create(options->fileCache, fileCacheSize * 1024 * 1024, fileCacheLFU ? DiskTileCache::LFU : DiskTileCache::LRU);
+            if (tileServer)
+            {
+                const auto& pathTemplate = tileServer->tilePathTemplate().string();
+                diskTileCache->prefixes.push_back(pathTemplate.substr(0, pathTemplate.find('{')));
+            }
+
+            diskTileCache->readerWriters = options->readerWriters;
+            options->readerWriters = {diskTileCache};
+            options->fileCache.clear();
+        }
+
+        // record the fetch and decode of the images read by vsg::read(paths, options), BatchReader and SimulatedTileServer record their own
+        if (!tileReader->batchReader && !tileServer) options->readerWriters.insert(options->readerWriters.begin(), TileLoadStatsReaderWriter::create());
+
         arguments.read("-t", tileReader->lodTransitionScreenHeightRatio);
         arguments.read("-m", tileReader->maxLevel);
 
@@ -89,9 +249,138 @@ int main(int argc, char** argv)
 
         if (arguments.errors()) return arguments.writeErrorMessages(std::cerr);
 
+        if (benchmark && pathFilename.empty())
+        {
+            std::cout << "--benchmark requires an animation path to fly, specified with -p path" << std::endl;
+            return 1;
+        }
+
         // initial the state that will be shared between tiles.
         tileReader->init();
 
+        // track the memory used by the loaded subtiles, limiting it to the --max-memory budget, in MB, when specified.
+        auto memoryBudget = TileMemoryBudget::create(maxMemory * 1024 * 1024);
+        tileReader->memoryBudget = memoryBudget;
+
+        // track the PagedLOD of each tile so the loads that are no longer needed can be counted, and cancelled if --cancel is set.
+        tileReader->tileInterest = TileInterest::create();
+
+        // prefetched images are passed on to the DatabasePager via the tileCache
+        if (prefetchTime > 0.0 && !tileReader->tileCache) tileReader->tileCache = TileCache::create(256 * 1024 * 1024);
+
+        if (readBenchmarkLevel >= 0)
+        {
+            // read all the subtiles down to the specified level, first with vsg::read(paths, options) and then with the BatchReader
+            vsg::Paths tiles;
+            for (uint32_t lod = 0; lod <= static_cast<uint32_t>(readBenchmarkLevel) && lod < tileReader->maxLevel; ++lod)
+            {
+                for (uint32_t y = 0; y < (tileReader->noY << lod); ++y)
+                {
+                    for (uint32_t x = 0; x < (tileReader->noX << lod); ++x)
+                    {
+                        tiles.push_back(vsg::make_string(x, " ", y, " ", lod, ".tile"));
+                    }
+                }
+            }
+
+            auto batchReader = tileReader->batchReader ? tileReader->batchReader : BatchReader::create();
+
+            auto readTiles = [&](vsg::ref_ptr<BatchReader> reader) {
+                tileReader->batchReader = reader;
+
+                uint32_t numFailed = 0;
+                auto startTime = vsg::clock::now();
+                for (auto& tile : tiles)
+                {
+                    if (!vsg::read(tile, options)) ++numFailed;
+                }
+                auto time = std::chrono::duration<double, std::chrono::milliseconds::period>(vsg::clock::now() - startTime).count();
+
+                if (numFailed > 0) std::cout << "    Warning: " << numFailed << " tiles failed to read." << std::endl;
+                return time;
+            };
+
+            // first pass so both of the timed passes read from a warm OS file cache
+            readTiles({});
+
+            auto standardTime = readTiles({});
+            auto batchTime = readTiles(batchReader);
+
+            std::cout << "Read benchmark, " << tiles.size() << " tiles each with 4 subtile images" << std::endl;
+            std::cout << "    vsg::read(paths) : " << standardTime << "ms, " << (static_cast<double>(tiles.size()) * 1000.0 / standardTime) << " tiles/second" << std::endl;
+            std::cout << "    BatchReader(" << (batchReader->backend == BatchReader::IO_URING ? "io_uring" : "thread pool") << ") : "
+                      << batchTime << "ms, " << (static_cast<double>(tiles.size()) * 1000.0 / batchTime) << " tiles/second" << std::endl;
+            return 0;
+        }
+
+        if (ecefBenchmarkTiles > 0)
+        {
+            // convert the vertices of 32x32 tiles spread across the globe, first per vertex in the way createECEFTile used to, then
+            // with the LocalECEFConverter batch and grid paths, checking that the batched results match the per vertex ones.
+            const uint32_t numRows = 32;
+            const uint32_t numCols = 32;
+            const uint32_t numVertices = numRows * numCols;
+            const double tileSize = 1.0; // degrees
+
+            struct Tile
+            {
+                vsg::dmat4 worldToLocal;
+                std::vector<double> latitudes;
+                std::vector<double> longitudes;
+                std::vector<vsg::dvec3> latitudeLongitudeAltitudes;
+            };
+
+            std::vector<Tile> tiles(ecefBenchmarkTiles);
+            for (uint32_t i = 0; i < ecefBenchmarkTiles; ++i)
+            {
+                auto& tile = tiles[i];
+                double latitudeOrigin = -80.0 + std::fmod(static_cast<double>(i) * 7.3, 160.0 - tileSize);
+                double longitudeOrigin = -180.0 + std::fmod(static_cast<double>(i) * 13.7, 360.0 - tileSize);
+                tile.worldToLocal = vsg::inverse(tileReader->ellipsoidModel->computeLocalToWorldTransform(vsg::dvec3(latitudeOrigin + tileSize * 0.5, longitudeOrigin + tileSize * 0.5, 0.0)));
+
+                for (uint32_t r = 0; r < numRows; ++r) tile.latitudes.push_back(latitudeOrigin + tileSize * double(r) / double(numRows - 1));
+                for (uint32_t c = 0; c < numCols; ++c) tile.longitudes.push_back(longitudeOrigin + tileSize * double(c) / double(numCols - 1));
+                for (auto latitude : tile.latitudes)
+                {
+                    for (auto longitude : tile.longitudes) tile.latitudeLongitudeAltitudes.push_back(vsg::dvec3(latitude, longitude, 0.0));
+                }
+            }
+
+            std::vector<vsg::vec3> reference(tiles.size() * numVertices);
+            std::vector<vsg::vec3> batched(tiles.size() * numVertices);
+
+            auto runConversion = [&](const std::string& name, auto convert, std::vector<vsg::vec3>& output) {
+                auto startTime = vsg::clock::now();
+                for (size_t t = 0; t < tiles.size(); ++t) convert(tiles[t], output.data() + t * numVertices);
+                auto time = std::chrono::duration<double, std::chrono::milliseconds::period>(vsg::clock::now() - startTime).count();
+
+                double maxError = 0.0;
+                for (size_t i = 0; i < output.size(); ++i) maxError = std::max(maxError, static_cast<double>(vsg::length(output[i] - reference[i])));
+
+                std::cout << "    " << name << " : " << time << "ms, " << (static_cast<double>(output.size()) * 1000.0 / time) << " vertices/second, max error = " << maxError << "m" << std::endl;
+            };
+
+            std::cout << "ECEF conversion benchmark, " << tiles.size() << " tiles of " << numRows << "x" << numCols << " vertices" << std::endl;
+
+            auto& ellipsoidModel = *tileReader->ellipsoidModel;
+            runConversion("per vertex", [&](const Tile& tile, vsg::vec3* vertices) {
+                for (size_t i = 0; i < tile.latitudeLongitudeAltitudes.size(); ++i)
+                {
+                    vertices[i] = vsg::vec3(tile.worldToLocal * ellipsoidModel.convertLatLongAltitudeToECEF(tile.latitudeLongitudeAltitudes[i]));
+                }
+            }, reference);
+
+            runConversion("LocalECEFConverter::convert", [&](const Tile& tile, vsg::vec3* vertices) {
+                LocalECEFConverter(ellipsoidModel, tile.worldToLocal).convert(tile.latitudeLongitudeAltitudes.data(), vertices, tile.latitudeLongitudeAltitudes.size());
+            }, batched);
+
+            runConversion("LocalECEFConverter::convertGrid", [&](const Tile& tile, vsg::vec3* vertices) {
+                LocalECEFConverter(ellipsoidModel, tile.worldToLocal).convertGrid(tile.latitudes.data(), numRows, tile.longitudes.data(), numCols, 0.0, vertices);
+            }, batched);
+
+            return 0;
+        }
+
         // load the root tile.
         auto vsg_scene = vsg::read_cast<vsg::Node>("root.tile", options);
         if (!vsg_scene) return 1;
@@ -163,7 +452,9 @@ int main(int argc, char** argv)
 
         // add close handler to respond the close window button and pressing escape
         viewer->addEventHandler(vsg::CloseHandler::create(viewer));
+        viewer->addEventHandler(TileLoadStatsHandler::create());
 
+        vsg::ref_ptr<vsg::AnimationPath> animationPath;
         if (pathFilename.empty())
         {
             if (ellipsoidModel)
@@ -195,7 +486,7 @@ int main(int argc, char** argv)
         }
         else
         {
-            auto animationPath = vsg::read_cast<vsg::AnimationPath>(pathFilename, options);
+            animationPath = vsg::read_cast<vsg::AnimationPath>(pathFilename, options);
             if (!animationPath)
             {
                 std::cout<<"Warning: unable to read animation path : "<<pathFilename<<std::endl;
@@ -207,14 +498,33 @@ int main(int argc, char** argv)
         // if required pre load specific number of PagedLOD levels.
         if (loadLevels > 0)
         {
-            vsg::LoadPagedLOD loadPagedLOD(camera, loadLevels);
-
             auto startTime = std::chrono::steady_clock::now();
 
-            vsg_scene->accept(loadPagedLOD);
+            uint32_t numTiles = 0;
+            if (numLoadThreads > 0)
+            {
+                // read the levels breadth first across the load threads, stopping at the --maxPagedLOD or --max-memory limits
+                auto loadPagedLOD = ParallelLoadPagedLOD::create(loadLevels, numLoadThreads);
+                loadPagedLOD->maxNumTiles = static_cast<uint32_t>(std::max(maxPagedLOD, 0));
+                loadPagedLOD->maxBytes = maxMemory * 1024 * 1024;
+                loadPagedLOD->load(*vsg_scene);
+                numTiles = loadPagedLOD->numTiles;
+
+                for (size_t level = 0; level < loadPagedLOD->numTilesPerLevel.size(); ++level)
+                {
+                    std::cout << "    level " << level << " tiles loaded " << loadPagedLOD->numTilesPerLevel[level] << std::endl;
+                }
+            }
+            else
+            {
+                vsg::LoadPagedLOD loadPagedLOD(camera, loadLevels);
+                vsg_scene->accept(loadPagedLOD);
+                numTiles = loadPagedLOD.numTiles;
+            }
 
             auto time = std::chrono::duration<float, std::chrono::milliseconds::period>(std::chrono::steady_clock::now() - startTime).count();
-            std::cout << "No. of tiles loaed " << loadPagedLOD.numTiles << " in " << time << "ms." << std::endl;
+            std::cout << "No. of tiles loaed " << numTiles << " in " << time << "ms, " << (time > 0.0f ? static_cast<float>(numTiles) * 1000.0f / time : 0.0f) << " tiles/second using "
+                      << (numLoadThreads > 0 ? vsg::make_string(numLoadThreads, " threads") : std::string("serial LoadPagedLOD")) << "." << std::endl;
         }
 
         auto commandGraph = vsg::createCommandGraphForView(window, camera, vsg_scene);
@@ -236,17 +546,101 @@ int main(int argc, char** argv)
             }
         }
 
+        vsg::ref_ptr<TilePrefetcher> prefetcher;
+        if (prefetchTime > 0.0)
+        {
+            prefetcher = TilePrefetcher::create(tileReader, options, numPrefetchThreads);
+            prefetcher->lookAhead = prefetchTime;
+            prefetcher->lodScale = std::abs(perspective->transform()[1][1]);
+            prefetcher->projection = perspective;
+
+            if (traceFilename && TRACE_ENABLED)
+            {
+                for (size_t i = 0; i < prefetcher->threads.size(); ++i)
+                {
+                    TraceEvents::instance().setThreadName(prefetcher->threads[i].get_id(), vsg::make_string("prefetch thread ", i));
+                }
+            }
+        }
+
+        // frames where the DatabasePager still has tiles to load, so coarser tiles are being shown in their place
+        uint64_t numFramesRendered = 0;
+        uint64_t numFramesWithMissingDetail = 0;
+
+        // the benchmark flies the animation path once
+        double benchmarkEndTime = (benchmark && !animationPath->locations.empty()) ? animationPath->locations.rbegin()->first : 0.0;
+        auto loopStartTime = vsg::clock::now();
+
         // rendering main loop
-        while (viewer->advanceToNextFrame() && (numFrames < 0 || (numFrames--) > 0))
+        while (viewer->active() && (numFrames < 0 || (numFrames--) > 0))
         {
+            {
+                TRACE_ZONE_CATEGORY("advanceToNextFrame", "frame");
+                if (!viewer->advanceToNextFrame()) break;
+            }
+
+            if (benchmark && std::chrono::duration<double, std::chrono::seconds::period>(viewer->getFrameStamp()->time - viewer->start_point()).count() > benchmarkEndTime) break;
+
+            tileReader->tileInterest->setFrameCount(viewer->getFrameStamp()->frameCount);
+
             // pass any events into EventHandlers assigned to the Viewer
             viewer->handleEvents();
 
-            viewer->update();
+            if (prefetcher)
+            {
+                TRACE_ZONE_CATEGORY("prefetch", "frame");
+                double time = std::chrono::duration<double, std::chrono::seconds::period>(viewer->getFrameStamp()->time - viewer->start_point()).count();
+                if (animationPath)
+                    prefetcher->update(time, *animationPath);
+                else
+                    prefetcher->update(time, *lookAt);
+            }
 
-            viewer->recordAndSubmit();
+            if (maxMemory > 0)
+            {
+                // adjust the DatabasePager's target number of tiles before it expires tiles in viewer->update()
+                for (auto& task : viewer->recordAndSubmitTasks)
+                {
+                    if (task->databasePager) memoryBudget->update(*task->databasePager);
+                }
+            }
 
-            viewer->present();
+            {
+                // includes the DatabasePager merging in the loaded tiles
+                TRACE_ZONE_CATEGORY("update", "frame");
+                viewer->update();
+            }
+
+            uint32_t numPendingTiles = 0;
+            for (auto& task : viewer->recordAndSubmitTasks)
+            {
+                if (task->databasePager) numPendingTiles += task->databasePager->numActiveRequests;
+            }
+            if (numPendingTiles > 0) ++numFramesWithMissingDetail;
+            TileLoadStats::instance().queueDepth.add(numPendingTiles);
+            ++numFramesRendered;
+
+            {
+                TRACE_ZONE_CATEGORY("recordAndSubmit", "frame");
+                viewer->recordAndSubmit();
+            }
+
+            {
+                TRACE_ZONE_CATEGORY("present", "frame");
+                viewer->present();
+            }
+        }
+
+        auto loopTime = std::chrono::duration<double, std::chrono::milliseconds::period>(vsg::clock::now() - loopStartTime).count();
+
+        if (prefetcher) prefetcher->stop();
+
+        if (traceFilename && TRACE_ENABLED)
+        {
+            if (TraceEvents::instance().write(traceFilename))
+                std::cout << "Trace written to " << traceFilename << ", view with chrome://tracing or https://ui.perfetto.dev" << std::endl;
+            else
+                std::cout << "Warning: unable to write trace to " << traceFilename << std::endl;
         }
 
         {
@@ -254,6 +648,85 @@ int main(int argc, char** argv)
             std::cout << "numOperationThreads = " << numOperationThreads << std::endl;
             std::cout << "numTilesRead = " << tileReader->numTilesRead << std::endl;
             std::cout << "average TimeReadingTiles = " << (tileReader->totalTimeReadingTiles / static_cast<double>(tileReader->numTilesRead)) << std::endl;
+
+            // time spent loading tiles per unit of time rendering is the average number of busy reading threads
+            double busyTime = tileReader->totalTimeReadingTiles + tileReader->timeCancelledReadingTiles;
+            double wastedTime = tileReader->timeWastedTileBuilds + tileReader->timeCancelledReadingTiles;
+            std::cout << "cancelObsoleteLoads = " << (tileReader->cancelObsoleteLoads ? "on" : "off") << ", tiles cancelled = " << tileReader->numTilesCancelled << ", wasted tile builds = " << tileReader->numWastedTileBuilds << std::endl;
+            std::cout << "    time loading tiles = " << busyTime << "ms, wasted = " << wastedTime << "ms, average busy reading threads = " << (busyTime / loopTime) << std::endl;
+        }
+
+        if (tileReader->tileCache)
+        {
+            auto stats = tileReader->tileCache->stats();
+            double hitRatio = (stats.hits + stats.misses) > 0 ? static_cast<double>(stats.hits) / static_cast<double>(stats.hits + stats.misses) : 0.0;
+            std::cout << "tileCache hits = " << stats.hits << ", misses = " << stats.misses << ", hit ratio = " << hitRatio * 100.0 << "%, evictions = " << stats.evictions << std::endl;
+            std::cout << "tileCache tiles = " << stats.numTiles << ", size = " << static_cast<double>(stats.bytes) / (1024.0 * 1024.0) << " of " << tileReader->tileCache->maxBytes / (1024 * 1024) << "MB" << std::endl;
+
+            if (prefetcher)
+            {
+                // prefetched images never requested by the DatabasePager, whether evicted or still in the cache, were wasted reads
+                std::cout << "prefetch subtiles requested = " << prefetcher->numRequested << ", dropped = " << prefetcher->numDropped << ", images read = " << prefetcher->numRead << std::endl;
+                std::cout << "prefetch images used = " << stats.prefetchedUsed << ", wasted = " << (stats.prefetchedEvicted + stats.prefetchedPending) << " (" << stats.prefetchedEvicted << " evicted, " << stats.prefetchedPending << " unused)" << std::endl;
+            }
+        }
+
+        std::cout << "frames with missing detail = " << numFramesWithMissingDetail << " of " << numFramesRendered << std::endl;
+
+        TileLoadStats::instance().report(std::cout);
+
+        if (tileServer)
+        {
+            auto stats = tileServer->stats();
+            std::cout << "simulated tile server requests = " << stats.numRequests << ", failed = " << stats.numFailed << ", cancelled = " << stats.numCancelled << ", transferred = " << static_cast<double>(stats.bytesTransferred) / (1024.0 * 1024.0) << "MB" << std::endl;
+            std::cout << "    image latency p50 = " << percentile(stats.latencies, 50.0) << "ms, p90 = " << percentile(stats.latencies, 90.0) << "ms, p99 = " << percentile(stats.latencies, 99.0) << "ms, max = " << percentile(stats.latencies, 100.0) << "ms" << std::endl;
+        }
+
+        if (diskTileCache)
+        {
+            auto stats = diskTileCache->stats();
+            double MB = 1024.0 * 1024.0;
+            uint64_t numReads = stats.numHits + stats.numMisses;
+            std::cout << "file cache hits = " << stats.numHits << ", misses = " << stats.numMisses << ", hit rate = " << (numReads > 0 ? 100.0 * static_cast<double>(stats.numHits) / static_cast<double>(numReads) : 0.0)
+                      << "%, failed integrity check = " << stats.numCorrupt << ", read from cache = " << static_cast<double>(stats.bytesRead) / MB << "MB" << std::endl;
+            std::cout << "    files = " << stats.numFiles << ", size = " << static_cast<double>(stats.totalBytes) / MB << "MB of " << fileCacheSize << "MB, evicted = " << stats.numEvicted << ", "
+                      << static_cast<double>(stats.bytesEvicted) / MB << "MB" << std::endl;
+        }
+
+        if (benchmark)
+        {
+            std::cout << "benchmark frames = " << numFramesRendered << ", average frame time = " << (loopTime / static_cast<double>(std::max(numFramesRendered, uint64_t(1)))) << "ms, "
+                      << "frames with pending loads = " << (100.0 * static_cast<double>(numFramesWithMissingDetail) / static_cast<double>(std::max(numFramesRendered, uint64_t(1)))) << "%" << std::endl;
+
+            auto& subtileTimes = TileLoadStats::instance().stage(TileLoadStats::SUBTILE);
+            std::cout << "    subtile read latency p50 = " << subtileTimes.percentile(50.0) << "ms, p90 = " << subtileTimes.percentile(90.0) << "ms, p99 = " << subtileTimes.percentile(99.0) << "ms, max = " << subtileTimes.max() << "ms" << std::endl;
+        }
+
+        {
+            auto collectMemory = CollectTileMemory::create();
+            vsg_scene->accept(*collectMemory);
+
+            double MB = 1024.0 * 1024.0;
+            std::cout << "resident tiles = " << collectMemory->numTiles << ", shareTileResources = " << (tileReader->shareTileResources ? "on" : "off") << ", compactVertices = " << (tileReader->compactVertices ? "on" : "off")
+                      << ", compressTextures = " << (tileReader->compressTextures ? "BC1" : "off") << std::endl;
+            if (tileReader->compressTextures)
+            {
+                std::scoped_lock<std::mutex> lock(tileReader->statsMutex);
+                std::cout << "    images compressed = " << tileReader->numImagesCompressed << ", not compressed = " << tileReader->numImagesNotCompressed << std::endl;
+            }
+            std::cout << "    geometry = " << static_cast<double>(CollectTileMemory::totalSize(collectMemory->geometry)) / MB << "MB, "
+                      << static_cast<double>(collectMemory->geometryReferencedSize) / MB << "MB if each tile had its own copy" << std::endl;
+            std::cout << "    images = " << static_cast<double>(CollectTileMemory::totalSize(collectMemory->images)) / MB << "MB" << std::endl;
+            std::cout << "    PagedLOD options = " << collectMemory->options.size() << std::endl;
+            std::cout << "    process resident memory = " << static_cast<double>(processResidentMemory()) / MB << "MB, peak = " << static_cast<double>(processResidentMemory("VmHWM:")) / MB << "MB" << std::endl;
+
+            // reloads are subtiles read again after being expired, the cost of keeping fewer tiles resident
+            auto stats = memoryBudget->stats();
+            double reloadRate = stats.numLoaded > 0 ? static_cast<double>(stats.numReloaded) / static_cast<double>(stats.numLoaded) : 0.0;
+            std::cout << "memory budget = " << (maxMemory > 0 ? vsg::make_string(maxMemory, "MB") : std::string("none")) << ", target subtiles = " << stats.targetNumTiles << ", subtiles = " << stats.numTiles << std::endl;
+            std::cout << "    subtile CPU memory = " << static_cast<double>(stats.cpuBytes) / MB << "MB, GPU memory = " << static_cast<double>(stats.gpuBytes) / MB << "MB, peak total = " << static_cast<double>(stats.peakBytes) / MB << "MB" << std::endl;
+            std::cout << "    subtiles loaded = " << stats.numLoaded << ", expired = " << stats.numExpired << ", reloaded = " << stats.numReloaded << ", reload rate = " << reloadRate * 100.0 << "%, "
+                      << (loopTime > 0.0 ? static_cast<double>(stats.numReloaded) * 1000.0 / loopTime : 0.0) << " reloads/second" << std::endl;
         }
     }
     catch (const vsg::Exception& ve)
@@ -7,6 +7,8 @@
 #include <iostream>
 #include <thread>
 
+#include "DiskTileCache.h"
+
 int main(int argc, char** argv)
 {
     // set up defaults and read command line arguments to override them
@@ -41,6 +43,8 @@ int main(int argc, char** argv)
     bool useEllipsoidPerspective = !arguments.read({"--disble-EllipsoidPerspective", "--dep"});
     if (arguments.read("--rgb")) options->mapRGBtoRGBAHint = false;
     arguments.read("--file-cache", options->fileCache);
+    auto fileCacheSize = arguments.value<size_t>(0, "--file-cache-size");
+    bool fileCacheLFU = arguments.read("--file-cache-lfu");
     bool osgEarthStyleMouseButtons = arguments.read({"--osgearth", "-e"});
 
     VkClearColorValue clearColor{{0.2f, 0.2f, 0.4f, 1.0f}};
@@ -49,6 +53,17 @@ int main(int argc, char** argv)
     uint32_t numOperationThreads = 0;
     if (arguments.read("--ot", numOperationThreads)) options->operationThreads = vsg::OperationThreads::create(numOperationThreads);
 
+    // manage the fileCache, limiting it to --file-cache-size MB by evicting the least recently used tiles, or with --file-cache-lfu
+    // the least frequently used. The DiskTileCache wraps all the ReaderWriters so it's the only one to write to the fileCache.
+    vsg::ref_ptr<DiskTileCache> diskTileCache;
+    if (fileCacheSize > 0 && options->fileCache)
+    {
+        diskTileCache = DiskTileCache::create(options->fileCache, fileCacheSize * 1024 * 1024, fileCacheLFU ? DiskTileCache::LFU : DiskTileCache::LRU);
+        diskTileCache->readerWriters = options->readerWriters;
+        options->readerWriters = {diskTileCache};
+        options->fileCache.clear();
+    }
+
     vsg::ref_ptr<vsg::TileDatabaseSettings> settings;
 
     if (arguments.read("--bing-maps"))
@@ -268,5 +283,16 @@ int main(int argc, char** argv)
         viewer->present();
     }
 
+    if (diskTileCache)
+    {
+        auto stats = diskTileCache->stats();
+        double MB = 1024.0 * 1024.0;
+        uint64_t numReads = stats.numHits + stats.numMisses;
+        std::cout << "file cache hits = " << stats.numHits << ", misses = " << stats.numMisses << ", hit rate = " << (numReads > 0 ? 100.0 * static_cast<double>(stats.numHits) / static_cast<double>(numReads) : 0.0)
+                  << "%, failed integrity check = " << stats.numCorrupt << ", read from cache = " << static_cast<double>(stats.bytesRead) / MB << "MB" << std::endl;
+        std::cout << "    files = " << stats.numFiles << ", size = " << static_cast<double>(stats.totalBytes) / MB << "MB of " << fileCacheSize << "MB, evicted = " << stats.numEvicted << ", "
+                  << static_cast<double>(stats.bytesEvicted) / MB << "MB" << std::endl;
+    }
+
     return 0;
 }
@@ -0,0 +1,166 @@
+#pragma once
+
+// C++20 coroutine support for writing read -> compile -> merge chains as a single function, enabled by building with the
+// VSGEXAMPLES_COROUTINES CMake option which compiles vsgdynamicload with C++20.
+//
+//     AsyncTask load(...)
+//     {
+//         auto node = co_await readAsync<vsg::Node>(filename, options, readThreads);     // resumes on a read thread
+//         auto result = co_await compileAsync(viewer, node, compileThreads);            // resumes on a compile thread
+//         if (co_await nextFrame(viewer)) { updateViewer(...); attachmentPoint->addChild(node); } // resumes in viewer.update()
+//     }
+//
+// While suspended a coroutine holds no thread, so no thread sits blocked waiting on another stage of the work.
+
+#include <vsg/all.h>
+
+#include <coroutine>
+#include <exception>
+#include <functional>
+#include <utility>
+
+// AsyncTask is the return type of fire and forget coroutines, which start running immediately on the calling thread.
+struct AsyncTask
+{
+    struct promise_type
+    {
+        AsyncTask get_return_object() noexcept { return {}; }
+        std::suspend_never initial_suspend() noexcept { return {}; }
+        std::suspend_never final_suspend() noexcept { return {}; }
+        void return_void() noexcept {}
+
+        void unhandled_exception() noexcept
+        {
+            try
+            {
+                std::rethrow_exception(std::current_exception());
+            }
+            catch (const vsg::Exception& ve)
+            {
+                vsg::warn("AsyncTask exception : ", ve.message);
+            }
+            catch (const std::exception& e)
+            {
+                vsg::warn("AsyncTask exception : ", e.what());
+            }
+            catch (...)
+            {
+                vsg::warn("AsyncTask unknown exception");
+            }
+        }
+    };
+};
+
+// ResumeOperation does optional work then resumes a suspended coroutine on the thread running the operation. If the
+// operation is discarded without being run, such as when its OperationThreads is stopped, the coroutine is destroyed
+// so that the objects it holds are released.
+struct ResumeOperation : public vsg::Inherit<vsg::Operation, ResumeOperation>
+{
+    explicit ResumeOperation(std::coroutine_handle<> in_handle, std::function<void()> in_work = {}) :
+        handle(in_handle),
+        work(in_work) {}
+
+    ~ResumeOperation()
+    {
+        if (handle) handle.destroy();
+    }
+
+    std::coroutine_handle<> handle;
+    std::function<void()> work;
+
+    void run() override
+    {
+        if (work) work();
+        std::exchange(handle, nullptr).resume();
+    }
+};
+
+// The awaitables and the coroutines using them only hold observer_ptr to the OperationThreads. A suspended coroutine is owned
+// by the ResumeOperation sitting in the threads' queue, so a ref_ptr held in its frame would form a cycle that keeps the
+// OperationThreads, and the coroutines queued on them, alive after the application has released them. If the threads have
+// already been deleted the coroutine isn't suspended and continues with a null result.
+
+// co_await readAsync<T>(filename, options, threads) reads the file on one of the threads, returning the result once resumed on that thread.
+template<class T>
+struct ReadAwaitable
+{
+    vsg::Path filename;
+    vsg::ref_ptr<const vsg::Options> options;
+    vsg::observer_ptr<vsg::OperationThreads> threads;
+    vsg::ref_ptr<T> result;
+
+    bool await_ready() const noexcept { return false; }
+
+    bool await_suspend(std::coroutine_handle<> handle)
+    {
+        vsg::ref_ptr<vsg::OperationThreads> ref_threads = threads;
+        if (!ref_threads) return false;
+
+        // the coroutine may be resumed and run to completion before add() returns so don't touch this afterwards
+        ref_threads->add(ResumeOperation::create(handle, [this]() { result = vsg::read_cast<T>(filename, options); }));
+        return true;
+    }
+
+    vsg::ref_ptr<T> await_resume() { return std::move(result); }
+};
+
+template<class T = vsg::Object>
+ReadAwaitable<T> readAsync(const vsg::Path& filename, vsg::ref_ptr<const vsg::Options> options, vsg::observer_ptr<vsg::OperationThreads> threads)
+{
+    return ReadAwaitable<T>{filename, options, threads, {}};
+}
+
+// co_await compileAsync(viewer, object, threads) compiles the object with the viewer's CompileManager on one of the threads.
+struct CompileAwaitable
+{
+    vsg::observer_ptr<vsg::Viewer> viewer;
+    vsg::ref_ptr<vsg::Object> object;
+    vsg::observer_ptr<vsg::OperationThreads> threads;
+    vsg::CompileResult result;
+
+    bool await_ready() const noexcept { return false; }
+
+    bool await_suspend(std::coroutine_handle<> handle)
+    {
+        vsg::ref_ptr<vsg::OperationThreads> ref_threads = threads;
+        if (!ref_threads) return false;
+
+        ref_threads->add(ResumeOperation::create(handle, [this]() {
+            vsg::ref_ptr<vsg::Viewer> ref_viewer = viewer;
+            if (ref_viewer) result = ref_viewer->compileManager->compile(object);
+        }));
+        return true;
+    }
+
+    vsg::CompileResult await_resume() { return result; }
+};
+
+inline CompileAwaitable compileAsync(vsg::observer_ptr<vsg::Viewer> viewer, vsg::ref_ptr<vsg::Object> object, vsg::observer_ptr<vsg::OperationThreads> threads)
+{
+    return CompileAwaitable{viewer, object, threads, {}};
+}
+
+// co_await nextFrame(viewer) resumes the coroutine from the viewer's update operations in the next viewer.update(), on the
+// main thread where it's safe to modify the scene graph. Returns false, without suspending, if the viewer has been deleted.
+struct NextFrameAwaitable
+{
+    vsg::observer_ptr<vsg::Viewer> viewer;
+
+    bool await_ready() const noexcept { return false; }
+
+    bool await_suspend(std::coroutine_handle<> handle)
+    {
+        vsg::ref_ptr<vsg::Viewer> ref_viewer = viewer;
+        if (!ref_viewer) return false;
+
+        ref_viewer->addUpdateOperation(ResumeOperation::create(handle));
+        return true;
+    }
+
+    bool await_resume() const { return viewer.valid(); }
+};
+
+inline NextFrameAwaitable nextFrame(vsg::observer_ptr<vsg::Viewer> viewer)
+{
+    return NextFrameAwaitable{viewer};
+}
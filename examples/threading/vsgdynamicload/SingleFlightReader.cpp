@@ -0,0 +1,62 @@
+#include "SingleFlightReader.h"
+
+#include <algorithm>
+#include <vector>
+
+vsg::ref_ptr<vsg::Object> SingleFlightReader::read(const vsg::Path& filename, vsg::ref_ptr<const vsg::Options> options) const
+{
+    Key key(filename, options.get());
+
+    // keys this thread is currently reading, when the nested vsg::read() comes back through this ReaderWriter
+    // return null so that it falls through to the ReaderWriters that actually read the file.
+    thread_local std::vector<Key> s_activeKeys;
+    if (std::find(s_activeKeys.begin(), s_activeKeys.end(), key) != s_activeKeys.end()) return {};
+
+    vsg::ref_ptr<Flight> flight;
+    bool leader = false;
+    {
+        std::scoped_lock<std::mutex> lock(_mutex);
+        auto& entry = _inFlight[key];
+        if (!entry)
+        {
+            entry = Flight::create();
+            leader = true;
+        }
+        flight = entry;
+    }
+
+    if (!leader)
+    {
+        ++numReadsAvoided;
+        flight->latch->wait();
+
+        // if the read failed the null return lets vsg::read() try the remaining ReaderWriters as it would have done anyway.
+        return flight->object;
+    }
+
+    ++numReads;
+
+    // once complete remove the flight so later reads go through the normal path, with SharedObjects providing reuse.
+    auto complete = [&]() {
+        s_activeKeys.pop_back();
+        {
+            std::scoped_lock<std::mutex> lock(_mutex);
+            _inFlight.erase(key);
+        }
+        flight->latch->count_down();
+    };
+
+    s_activeKeys.push_back(key);
+    try
+    {
+        flight->object = vsg::read(filename, options);
+    }
+    catch (...)
+    {
+        complete();
+        throw;
+    }
+    complete();
+
+    return flight->object;
+}
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <vsg/all.h>
+
+#include <atomic>
+#include <map>
+#include <mutex>
+
+// SingleFlightReader collapses concurrent reads of the same file into a single read. The first thread to request a
+// filename/options pair performs the read, any other threads requesting it while that read is in flight wait for it
+// to complete and share the resulting object rather than parsing the file again themselves.
+// Place it at the front of Options::readerWriters so that it sees all reads, including nested reads of textures etc.
+class SingleFlightReader : public vsg::Inherit<vsg::ReaderWriter, SingleFlightReader>
+{
+public:
+    vsg::ref_ptr<vsg::Object> read(const vsg::Path& filename, vsg::ref_ptr<const vsg::Options> options = {}) const override;
+
+    // stats
+    mutable std::atomic_uint64_t numReads{0};
+    mutable std::atomic_uint64_t numReadsAvoided{0};
+
+protected:
+    struct Flight : public vsg::Inherit<vsg::Object, Flight>
+    {
+        vsg::ref_ptr<vsg::Latch> latch = vsg::Latch::create(1);
+        vsg::ref_ptr<vsg::Object> object;
+    };
+
+    using Key = std::pair<vsg::Path, const vsg::Options*>;
+
+    mutable std::mutex _mutex;
+    mutable std::map<Key, vsg::ref_ptr<Flight>> _inFlight;
+};
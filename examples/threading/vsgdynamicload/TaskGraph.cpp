@@ -0,0 +1,178 @@
+#include "TaskGraph.h"
+
+#include <algorithm>
+#include <iomanip>
+
+namespace
+{
+    int64_t nanoseconds(vsg::time_point start, vsg::time_point end)
+    {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+    }
+
+    double milliseconds(int64_t nanoseconds)
+    {
+        return static_cast<double>(nanoseconds) / 1.0e6;
+    }
+
+    // the status may be shared with the viewer and set inactive without a notification so don't wait indefinitely
+    const std::chrono::milliseconds waitInterval(100);
+} // namespace
+
+TaskGraph::Stage::Stage(const std::string& in_name, uint32_t in_numThreads, size_t in_capacity, Function in_function) :
+    name(in_name),
+    numThreads(std::max(1u, in_numThreads)),
+    capacity(in_capacity),
+    function(in_function)
+{
+}
+
+size_t TaskGraph::Stage::depth() const
+{
+    std::scoped_lock<std::mutex> lock(_mutex);
+    return _queue.size();
+}
+
+bool TaskGraph::Stage::push(vsg::ref_ptr<vsg::Object> job, const TaskGraph& graph)
+{
+    std::unique_lock<std::mutex> lock(_mutex);
+
+    if (capacity > 0 && _queue.size() >= capacity)
+    {
+        auto startWait = vsg::clock::now();
+        while (_queue.size() >= capacity && graph.active())
+        {
+            _notFull.wait_for(lock, waitInterval);
+        }
+        blockedTime += nanoseconds(startWait, vsg::clock::now());
+
+        if (!graph.active()) return false;
+    }
+
+    _queue.push_back(job);
+    if (_queue.size() > maxDepth) maxDepth = _queue.size();
+
+    lock.unlock();
+    _notEmpty.notify_one();
+    return true;
+}
+
+bool TaskGraph::Stage::take(vsg::ref_ptr<vsg::Object>& job, const TaskGraph& graph)
+{
+    std::unique_lock<std::mutex> lock(_mutex);
+    while (_queue.empty())
+    {
+        if (!graph.active()) return false;
+        _notEmpty.wait_for(lock, waitInterval);
+    }
+
+    job = _queue.front();
+    _queue.pop_front();
+
+    lock.unlock();
+    _notFull.notify_one();
+    return true;
+}
+
+TaskGraph::TaskGraph(vsg::ref_ptr<vsg::ActivityStatus> in_status) :
+    status(in_status)
+{
+    if (!status) status = vsg::ActivityStatus::create();
+}
+
+TaskGraph::~TaskGraph()
+{
+    stop();
+}
+
+vsg::ref_ptr<TaskGraph::Stage> TaskGraph::addStage(const std::string& name, uint32_t numThreads, size_t capacity, Function function)
+{
+    auto stage = Stage::create(name, numThreads, capacity, function);
+    stages.push_back(stage);
+    return stage;
+}
+
+void TaskGraph::connect(vsg::ref_ptr<Stage> from, vsg::ref_ptr<Stage> to)
+{
+    from->successors.push_back(to);
+}
+
+void TaskGraph::start()
+{
+    if (_active.exchange(true)) return;
+
+    for (auto& stage : stages)
+    {
+        for (uint32_t i = 0; i < stage->numThreads; ++i)
+        {
+            stage->threads.emplace_back([this, stage]() { runStage(*stage); });
+        }
+    }
+}
+
+bool TaskGraph::add(vsg::ref_ptr<Stage> stage, vsg::ref_ptr<vsg::Object> job)
+{
+    return stage->push(job, *this);
+}
+
+void TaskGraph::runStage(Stage& stage)
+{
+    vsg::ref_ptr<vsg::Object> job;
+    while (stage.take(job, *this))
+    {
+        auto startTime = vsg::clock::now();
+        bool passOn = stage.function(*job);
+        stage.processingTime += nanoseconds(startTime, vsg::clock::now());
+        ++stage.numProcessed;
+
+        if (passOn)
+        {
+            for (auto& successor : stage.successors)
+            {
+                if (!successor->push(job, *this)) break;
+            }
+        }
+        else
+        {
+            ++stage.numDropped;
+        }
+
+        job = {};
+    }
+}
+
+void TaskGraph::stop()
+{
+    if (!_active.exchange(false)) return;
+
+    for (auto& stage : stages)
+    {
+        stage->_notEmpty.notify_all();
+        stage->_notFull.notify_all();
+    }
+
+    for (auto& stage : stages)
+    {
+        for (auto& thread : stage->threads)
+        {
+            if (thread.joinable()) thread.join();
+        }
+        stage->threads.clear();
+
+        std::scoped_lock<std::mutex> lock(stage->_mutex);
+        stage->_queue.clear();
+    }
+}
+
+void TaskGraph::report(std::ostream& out) const
+{
+    for (auto& stage : stages)
+    {
+        auto numProcessed = stage->numProcessed.load();
+        out << "    " << std::left << std::setw(10) << stage->name << std::right << " threads = " << stage->numThreads << ", processed = " << numProcessed << ", dropped = " << stage->numDropped;
+        if (numProcessed > 0) out << ", average = " << milliseconds(stage->processingTime) / static_cast<double>(numProcessed) << "ms";
+        out << ", max queue depth = " << stage->maxDepth;
+        if (stage->capacity > 0) out << "/" << stage->capacity << ", blocked upstream = " << milliseconds(stage->blockedTime) << "ms";
+        out << std::endl;
+    }
+}
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <vsg/all.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <ostream>
+#include <thread>
+
+// TaskGraph runs jobs through a directed acyclic graph of stages, each stage with its own threads and bounded input queue.
+// Once a stage's queue is full the threads of the stages feeding it block until there is space, so a fast I/O stage can't
+// run far ahead of a slower compile stage, holding ever more loaded but uncompiled data in memory.
+class TaskGraph : public vsg::Inherit<vsg::Object, TaskGraph>
+{
+public:
+    // process job, returning false to drop it rather than pass it on to the successor stages.
+    using Function = std::function<bool(vsg::Object& job)>;
+
+    class Stage : public vsg::Inherit<vsg::Object, Stage>
+    {
+    public:
+        Stage(const std::string& in_name, uint32_t in_numThreads, size_t in_capacity, Function in_function);
+
+        const std::string name;
+        const uint32_t numThreads;
+        const size_t capacity; // 0 for an unbounded queue, appropriate for stages fed from the main thread
+        Function function;
+
+        // each job completed by this stage is passed on to all of its successors
+        std::vector<vsg::ref_ptr<Stage>> successors;
+        std::vector<std::thread> threads;
+
+        std::atomic<uint64_t> numProcessed{0};
+        std::atomic<uint64_t> numDropped{0};
+        std::atomic<int64_t> processingTime{0}; // nanoseconds
+        std::atomic<int64_t> blockedTime{0};    // nanoseconds spent by callers waiting for space in this stage's queue
+        std::atomic<size_t> maxDepth{0};
+
+        size_t depth() const;
+
+    protected:
+        friend class TaskGraph;
+
+        bool push(vsg::ref_ptr<vsg::Object> job, const TaskGraph& graph);
+        bool take(vsg::ref_ptr<vsg::Object>& job, const TaskGraph& graph);
+
+        mutable std::mutex _mutex;
+        std::condition_variable _notEmpty;
+        std::condition_variable _notFull;
+        std::deque<vsg::ref_ptr<vsg::Object>> _queue;
+    };
+
+    explicit TaskGraph(vsg::ref_ptr<vsg::ActivityStatus> in_status = {});
+    TaskGraph(const TaskGraph&) = delete;
+    ~TaskGraph();
+
+    vsg::ref_ptr<vsg::ActivityStatus> status;
+    std::vector<vsg::ref_ptr<Stage>> stages;
+
+    vsg::ref_ptr<Stage> addStage(const std::string& name, uint32_t numThreads, size_t capacity, Function function);
+    void connect(vsg::ref_ptr<Stage> from, vsg::ref_ptr<Stage> to);
+
+    // start the threads of all the stages.
+    void start();
+
+    // add a job to a stage, blocking while the stage's queue is full.
+    bool add(vsg::ref_ptr<Stage> stage, vsg::ref_ptr<vsg::Object> job);
+
+    // stop the threads, discarding any jobs still queued.
+    void stop();
+
+    bool active() const { return _active && status->active(); }
+
+    // write the per stage stats.
+    void report(std::ostream& out) const;
+
+protected:
+    void runStage(Stage& stage);
+
+    std::atomic_bool _active{false};
+};
@@ -0,0 +1,187 @@
+#pragma once
+
+#include <vsg/all.h>
+
+#include <atomic>
+#include <fstream>
+#include <iomanip>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+// TraceEvents collects timed zones from all threads and writes them out in the Chrome trace-event JSON format, viewable
+// with chrome://tracing or https://ui.perfetto.dev, with each thread shown as its own track.
+// Zones are added with TRACE_ZONE(name), which compiles to nothing unless VSGEXAMPLES_TRACE is defined, and are only recorded
+// once enabled is set, by --trace, so the events don't accumulate in runs that won't write them out.
+class TraceEvents
+{
+public:
+    static TraceEvents& instance()
+    {
+        static TraceEvents s_traceEvents;
+        return s_traceEvents;
+    }
+
+    std::atomic_bool enabled{false};
+
+    void add(std::string name, const char* category, vsg::time_point start, vsg::time_point end)
+    {
+        if (!enabled.load(std::memory_order_relaxed)) return;
+
+        auto& threadEvents = getThreadEvents();
+        std::scoped_lock<std::mutex> lock(threadEvents.mutex);
+        threadEvents.events.push_back(Event{std::move(name), category, start, end});
+    }
+
+    void setThreadName(std::thread::id id, const std::string& name)
+    {
+        std::scoped_lock<std::mutex> lock(_mutex);
+        _threadNames[id] = name;
+    }
+
+    bool write(const vsg::Path& filename)
+    {
+        std::ofstream fout(filename.c_str());
+        if (!fout) return false;
+
+        std::scoped_lock<std::mutex> lock(_mutex);
+
+        auto microseconds = [&](vsg::time_point time) { return std::chrono::duration<double, std::chrono::microseconds::period>(time - _startTime).count(); };
+
+        fout << std::fixed << std::setprecision(3);
+        fout << "{\"traceEvents\":[\n";
+        bool first = true;
+        for (size_t tid = 0; tid < _threads.size(); ++tid)
+        {
+            auto& threadEvents = *_threads[tid];
+            std::scoped_lock<std::mutex> threadLock(threadEvents.mutex);
+
+            auto itr = _threadNames.find(threadEvents.threadId);
+            auto threadName = (itr != _threadNames.end()) ? itr->second : vsg::make_string("thread ", tid);
+
+            fout << (first ? "" : ",\n") << R"({"name":"thread_name","ph":"M","pid":1,"tid":)" << tid << R"(,"args":{"name":")" << escape(threadName) << "\"}}";
+            first = false;
+
+            for (auto& event : threadEvents.events)
+            {
+                fout << ",\n{\"name\":\"" << escape(event.name) << "\",\"cat\":\"" << event.category << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << tid
+                     << ",\"ts\":" << microseconds(event.start) << ",\"dur\":" << microseconds(event.end) - microseconds(event.start) << "}";
+            }
+        }
+        fout << "\n]}\n";
+        return fout.good();
+    }
+
+protected:
+    TraceEvents() :
+        _startTime(vsg::clock::now()) {}
+
+    struct Event
+    {
+        std::string name;
+        const char* category;
+        vsg::time_point start;
+        vsg::time_point end;
+    };
+
+    struct ThreadEvents
+    {
+        std::thread::id threadId;
+        std::mutex mutex; // only contended when writing out
+        std::vector<Event> events;
+    };
+
+    ThreadEvents& getThreadEvents()
+    {
+        thread_local ThreadEvents* s_threadEvents = nullptr;
+        if (!s_threadEvents)
+        {
+            std::scoped_lock<std::mutex> lock(_mutex);
+            _threads.push_back(std::make_unique<ThreadEvents>());
+            _threads.back()->threadId = std::this_thread::get_id();
+            s_threadEvents = _threads.back().get();
+        }
+        return *s_threadEvents;
+    }
+
+    static std::string escape(const std::string& str)
+    {
+        std::string result;
+        for (auto c : str)
+        {
+            if (c == '"' || c == '\\') result.push_back('\\');
+            if (static_cast<unsigned char>(c) >= 0x20) result.push_back(c);
+        }
+        return result;
+    }
+
+    vsg::time_point _startTime;
+    std::mutex _mutex;
+    std::vector<std::unique_ptr<ThreadEvents>> _threads;
+    std::map<std::thread::id, std::string> _threadNames;
+};
+
+// TraceZone records the time from its construction to its destruction, when TraceEvents is enabled.
+struct TraceZone
+{
+    explicit TraceZone(std::string in_name, const char* in_category = "vsg") :
+        active(TraceEvents::instance().enabled.load(std::memory_order_relaxed)),
+        name(active ? std::move(in_name) : std::string()),
+        category(in_category),
+        start(active ? vsg::clock::now() : vsg::time_point()) {}
+
+    ~TraceZone()
+    {
+        if (active) TraceEvents::instance().add(std::move(name), category, start, vsg::clock::now());
+    }
+
+    bool active;
+    std::string name;
+    const char* category;
+    vsg::time_point start;
+};
+
+// TraceReaderWriter records a "read" zone for each file read, placed at the front of Options::readerWriters it sees the
+// reads done by the VSG on OperationThreads as well as the nested reads of textures etc.
+class TraceReaderWriter : public vsg::Inherit<vsg::ReaderWriter, TraceReaderWriter>
+{
+public:
+    vsg::ref_ptr<vsg::Object> read(const vsg::Path& filename, vsg::ref_ptr<const vsg::Options> options = {}) const override
+    {
+        // when the nested vsg::read() comes back through this ReaderWriter return null so it falls through to the other ReaderWriters
+        thread_local const vsg::Path* s_activeFilename = nullptr;
+        if (s_activeFilename && *s_activeFilename == filename) return {};
+
+        auto previousFilename = s_activeFilename;
+        s_activeFilename = &filename;
+
+        TraceZone zone(filename.string(), "read");
+        vsg::ref_ptr<vsg::Object> object;
+        try
+        {
+            object = vsg::read(filename, options);
+        }
+        catch (...)
+        {
+            s_activeFilename = previousFilename;
+            throw;
+        }
+
+        s_activeFilename = previousFilename;
+        return object;
+    }
+};
+
+#define TRACE_CONCATENATE_DETAIL(x, y) x##y
+#define TRACE_CONCATENATE(x, y) TRACE_CONCATENATE_DETAIL(x, y)
+
+#ifdef VSGEXAMPLES_TRACE
+#    define TRACE_ENABLED 1
+#    define TRACE_ZONE(name) TraceZone TRACE_CONCATENATE(traceZone, __LINE__)(name)
+#    define TRACE_ZONE_CATEGORY(name, category) TraceZone TRACE_CONCATENATE(traceZone, __LINE__)(name, category)
+#else
+#    define TRACE_ENABLED 0
+#    define TRACE_ZONE(name)
+#    define TRACE_ZONE_CATEGORY(name, category)
+#endif
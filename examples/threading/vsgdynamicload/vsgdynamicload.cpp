@@ -5,10 +5,19 @@
 #endif
 
 #include <algorithm>
+#include <atomic>
 #include <chrono>
+#include <fstream>
 #include <iostream>
 #include <thread>
 
+#ifdef VSGEXAMPLES_COROUTINES
+#    include "AsyncLoad.h"
+#endif
+#include "SingleFlightReader.h"
+#include "TaskGraph.h"
+#include "TraceEvents.h"
+
 struct Merge : public vsg::Inherit<vsg::Operation, Merge>
 {
     Merge(const vsg::Path& in_path, vsg::observer_ptr<vsg::Viewer> in_viewer, vsg::ref_ptr<vsg::Group> in_attachmentPoint, vsg::ref_ptr<vsg::Node> in_node, const vsg::CompileResult& in_compileResult):
@@ -23,9 +32,12 @@ struct Merge : public vsg::Inherit<vsg::Operation, Merge>
     vsg::ref_ptr<vsg::Group> attachmentPoint;
     vsg::ref_ptr<vsg::Node> node;
     vsg::CompileResult compileResult;
+    std::atomic_int* pendingMerges = nullptr;
 
     void run() override
     {
+        TRACE_ZONE_CATEGORY("Merge::run", "merge");
+
         std::cout<<"Merge::run() path = "<<path<<", "<<attachmentPoint<<", "<<node<<std::endl;
 
         vsg::ref_ptr<vsg::Viewer> ref_viewer = viewer;
@@ -35,6 +47,8 @@ struct Merge : public vsg::Inherit<vsg::Operation, Merge>
         }
 
         attachmentPoint->addChild(node);
+
+        if (pendingMerges) --(*pendingMerges);
     }
 };
 
@@ -53,10 +67,18 @@ struct LoadOperation : public vsg::Inherit<vsg::Operation, LoadOperation>
 
     void run() override
     {
+        TRACE_ZONE_CATEGORY("LoadOperation::run", "operation");
+
         vsg::ref_ptr<vsg::Viewer > ref_viewer = viewer;
 
         // std::cout << "Loading " << filename << std::endl;
-        if (auto node = vsg::read_cast<vsg::Node>(filename, options))
+        vsg::ref_ptr<vsg::Node> node;
+        {
+            TRACE_ZONE_CATEGORY(filename.string(), "read");
+            node = vsg::read_cast<vsg::Node>(filename, options);
+        }
+
+        if (node)
         {
             // std::cout << "Loaded " << filename << std::endl;
 
@@ -69,12 +91,142 @@ struct LoadOperation : public vsg::Inherit<vsg::Operation, LoadOperation>
 
             scale->addChild(node);
 
-            auto result = ref_viewer->compileManager->compile(node);
+            vsg::CompileResult result;
+            {
+                TRACE_ZONE_CATEGORY("compile", "compile");
+                result = ref_viewer->compileManager->compile(node);
+            }
             if (result) ref_viewer->addUpdateOperation(Merge::create(filename, viewer, attachmentPoint, scale, result));
         }
     }
 };
 
+// LoadJob carries a model through the stages of the TaskGraph used with --pipeline, splitting the work that LoadOperation
+// does on a single thread into read (I/O bound), build (CPU bound), compile (GPU transfer bound) and merge stages.
+struct LoadJob : public vsg::Inherit<vsg::Object, LoadJob>
+{
+    LoadJob(vsg::ref_ptr<vsg::Group> in_attachmentPoint, const vsg::Path& in_filename) :
+        attachmentPoint(in_attachmentPoint),
+        filename(in_filename) {}
+
+    vsg::ref_ptr<vsg::Group> attachmentPoint;
+    vsg::Path filename;
+    vsg::ref_ptr<vsg::Node> node;
+    vsg::ref_ptr<vsg::MatrixTransform> scale;
+    vsg::CompileResult compileResult;
+};
+
+vsg::ref_ptr<TaskGraph> createLoadPipeline(vsg::observer_ptr<vsg::Viewer> viewer, vsg::ref_ptr<vsg::Options> options, uint32_t numReadThreads, size_t queueSize, int maxPendingMerges, std::atomic_int& pendingMerges)
+{
+    vsg::ref_ptr<vsg::Viewer> ref_viewer = viewer;
+    auto taskGraph = TaskGraph::create(ref_viewer->status);
+
+    // the main thread adds all the jobs up front, so only the read stage has an unbounded queue
+    auto read = taskGraph->addStage("read", numReadThreads, 0, [options](vsg::Object& object) {
+        auto& job = static_cast<LoadJob&>(object);
+        TRACE_ZONE_CATEGORY(job.filename.string(), "read");
+        job.node = vsg::read_cast<vsg::Node>(job.filename, options);
+        return job.node.valid();
+    });
+
+    auto build = taskGraph->addStage("build", 2, queueSize, [](vsg::Object& object) {
+        auto& job = static_cast<LoadJob&>(object);
+        TRACE_ZONE_CATEGORY("build", "build");
+
+        vsg::ComputeBounds computeBounds;
+        job.node->accept(computeBounds);
+
+        vsg::dvec3 centre = (computeBounds.bounds.min + computeBounds.bounds.max) * 0.5;
+        double radius = vsg::length(computeBounds.bounds.max - computeBounds.bounds.min) * 0.5;
+        job.scale = vsg::MatrixTransform::create(vsg::scale(1.0 / radius, 1.0 / radius, 1.0 / radius) * vsg::translate(-centre));
+        job.scale->addChild(job.node);
+        return true;
+    });
+
+    // the CompileManager serializes compiles on its compile traversals so more threads would just wait on each other
+    auto compile = taskGraph->addStage("compile", 1, queueSize, [viewer](vsg::Object& object) {
+        auto& job = static_cast<LoadJob&>(object);
+        TRACE_ZONE_CATEGORY("compile", "compile");
+
+        vsg::ref_ptr<vsg::Viewer> ref_viewer = viewer;
+        if (!ref_viewer) return false;
+
+        job.compileResult = ref_viewer->compileManager->compile(job.node);
+        return static_cast<bool>(job.compileResult);
+    });
+
+    // limit the number of merges waiting for viewer.update() so that a burst of completed loads is spread over several
+    // frames, with the wait backing up through the bounded queues of the earlier stages.
+    auto merge = taskGraph->addStage("merge", 1, queueSize, [viewer, taskGraph = taskGraph.get(), maxPendingMerges, &pendingMerges](vsg::Object& object) {
+        auto& job = static_cast<LoadJob&>(object);
+
+        while (pendingMerges.load() >= maxPendingMerges && taskGraph->active())
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+
+        vsg::ref_ptr<vsg::Viewer> ref_viewer = viewer;
+        if (!ref_viewer) return false;
+
+        auto mergeOperation = Merge::create(job.filename, viewer, job.attachmentPoint, job.scale, job.compileResult);
+        mergeOperation->pendingMerges = &pendingMerges;
+        ++pendingMerges;
+        ref_viewer->addUpdateOperation(mergeOperation);
+        return true;
+    });
+
+    taskGraph->connect(read, build);
+    taskGraph->connect(build, compile);
+    taskGraph->connect(compile, merge);
+
+    return taskGraph;
+}
+
+#ifdef VSGEXAMPLES_COROUTINES
+// the same read, build, compile and merge steps as LoadOperation and Merge written as a single coroutine, with the read on
+// one of the read threads, the compile on the compile thread and the merge in viewer.update() on the main thread.
+AsyncTask loadModel(vsg::observer_ptr<vsg::Viewer> viewer, vsg::ref_ptr<vsg::Group> attachmentPoint, vsg::Path filename, vsg::ref_ptr<vsg::Options> options,
+                    vsg::observer_ptr<vsg::OperationThreads> readThreads, vsg::observer_ptr<vsg::OperationThreads> compileThreads)
+{
+    auto node = co_await readAsync<vsg::Node>(filename, options, readThreads);
+    if (!node) co_return;
+
+    vsg::ComputeBounds computeBounds;
+    node->accept(computeBounds);
+
+    vsg::dvec3 centre = (computeBounds.bounds.min + computeBounds.bounds.max) * 0.5;
+    double radius = vsg::length(computeBounds.bounds.max - computeBounds.bounds.min) * 0.5;
+    auto scale = vsg::MatrixTransform::create(vsg::scale(1.0 / radius, 1.0 / radius, 1.0 / radius) * vsg::translate(-centre));
+    scale->addChild(node);
+
+    auto result = co_await compileAsync(viewer, node, compileThreads);
+    if (!result) co_return;
+
+    if (!co_await nextFrame(viewer)) co_return;
+
+    TRACE_ZONE_CATEGORY("merge", "merge");
+
+    vsg::ref_ptr<vsg::Viewer> ref_viewer = viewer;
+    if (ref_viewer) updateViewer(*ref_viewer, result);
+
+    attachmentPoint->addChild(scale);
+}
+#endif
+
+// number of threads in the process, or 0 where it can't be determined.
+size_t processThreadCount()
+{
+#if defined(__linux__)
+    std::ifstream fin("/proc/self/status");
+    std::string line;
+    while (std::getline(fin, line))
+    {
+        if (line.compare(0, 8, "Threads:") == 0) return static_cast<size_t>(std::stoul(line.substr(8)));
+    }
+#endif
+    return 0;
+}
+
 int main(int argc, char** argv)
 {
     try
@@ -105,6 +257,28 @@ int main(int argc, char** argv)
         arguments.read("--display", windowTraits->display);
         auto numFrames = arguments.value(-1, "-f");
         auto numThreads = arguments.value(16, "-n");
+        auto usePipeline = arguments.read("--pipeline");
+        auto queueSize = arguments.value<size_t>(8, "--queue");
+        auto maxPendingMerges = arguments.value(2, "--merges");
+        auto useCoroutines = arguments.read("--coroutines");
+#ifndef VSGEXAMPLES_COROUTINES
+        if (useCoroutines)
+        {
+            std::cout << "Warning: --coroutines requires building with VSGEXAMPLES_COROUTINES enabled." << std::endl;
+            useCoroutines = false;
+        }
+#endif
+        auto traceFilename = arguments.value(vsg::Path(), "--trace");
+        if (traceFilename && !TRACE_ENABLED) std::cout << "Warning: --trace requires building with VSGEXAMPLES_TRACE enabled." << std::endl;
+        TraceEvents::instance().enabled = traceFilename && TRACE_ENABLED;
+
+        // collapse concurrent reads of the same file, such as shared textures or models listed several times, into a single read
+        vsg::ref_ptr<SingleFlightReader> singleFlightReader;
+        if (!arguments.read("--no-single-flight"))
+        {
+            singleFlightReader = SingleFlightReader::create();
+            options->readerWriters.insert(options->readerWriters.begin(), singleFlightReader);
+        }
 
         // provide setting of the resource hints on the command line
         vsg::ref_ptr<vsg::ResourceHints> resourceHints;
@@ -173,10 +347,57 @@ int main(int argc, char** argv)
         // configure the viewers rendering backend, initialize and compile Vulkan objects, passing in ResourceHints to guide the resources allocated.
         viewer->compile(resourceHints);
 
-        auto loadThreads = vsg::OperationThreads::create(numThreads, viewer->status);
+        auto startTime = vsg::clock::now();
+
+        // name the tracks of the trace output
+        TraceEvents::instance().setThreadName(std::this_thread::get_id(), "main");
 
-        // assign the LoadOperation that will do the load in the background and once loaded and compiled merged then via Merge operation that is assigned to updateOperations and called from viewer.update()
         vsg::observer_ptr<vsg::Viewer> observer_viewer(viewer);
+        std::atomic_int pendingMerges{0};
+        vsg::ref_ptr<vsg::OperationThreads> loadThreads;
+        vsg::ref_ptr<vsg::OperationThreads> compileThreads;
+        vsg::ref_ptr<TaskGraph> loadPipeline;
+        size_t numLoadThreads = 0;
+        if (useCoroutines)
+        {
+            // coroutines don't hold a thread while waiting for the compile, so a single compile thread matching the
+            // CompileManager's serialized compiles leaves the read threads free to keep reading
+            loadThreads = vsg::OperationThreads::create(numThreads, viewer->status);
+            compileThreads = vsg::OperationThreads::create(1, viewer->status);
+            numLoadThreads = loadThreads->threads.size() + compileThreads->threads.size();
+
+            for (size_t i = 0; i < loadThreads->threads.size(); ++i)
+            {
+                TraceEvents::instance().setThreadName(loadThreads->threads[i].get_id(), vsg::make_string("read thread ", i));
+            }
+            TraceEvents::instance().setThreadName(compileThreads->threads.front().get_id(), "compile thread");
+        }
+        else if (usePipeline)
+        {
+            loadPipeline = createLoadPipeline(observer_viewer, options, numThreads, queueSize, maxPendingMerges, pendingMerges);
+            loadPipeline->start();
+
+            for (auto& stage : loadPipeline->stages)
+            {
+                for (size_t i = 0; i < stage->threads.size(); ++i)
+                {
+                    TraceEvents::instance().setThreadName(stage->threads[i].get_id(), vsg::make_string(stage->name, " thread ", i));
+                }
+                numLoadThreads += stage->threads.size();
+            }
+        }
+        else
+        {
+            loadThreads = vsg::OperationThreads::create(numThreads, viewer->status);
+            numLoadThreads = loadThreads->threads.size();
+
+            for (size_t i = 0; i < loadThreads->threads.size(); ++i)
+            {
+                TraceEvents::instance().setThreadName(loadThreads->threads[i].get_id(), vsg::make_string("load thread ", i));
+            }
+        }
+
+        // assign the LoadOperation that will do the load in the background and once loaded and compiled merged then via Merge operation that is assigned to updateOperations and called from viewer.update()
         for (int i = 1; i < argc; ++i)
         {
             int index = i - 1;
@@ -185,24 +406,114 @@ int main(int argc, char** argv)
 
             vsg_scene->addChild(transform);
 
-            loadThreads->add(LoadOperation::create(observer_viewer, transform, argv[i], options));
+            if (useCoroutines)
+            {
+#ifdef VSGEXAMPLES_COROUTINES
+                loadModel(observer_viewer, transform, argv[i], options, loadThreads, compileThreads);
+#endif
+            }
+            else if (loadPipeline)
+                loadPipeline->add(loadPipeline->stages.front(), LoadJob::create(transform, argv[i]));
+            else
+                loadThreads->add(LoadOperation::create(observer_viewer, transform, argv[i], options));
         }
 
+        double loadTime = 0.0;
+
+        // frame times while loading, to see the frame spikes caused by merging many models in a single update
+        std::vector<double> frameTimes;
+        auto previousFrameTime = vsg::clock::now();
+
+        // time from starting the loads to each model being merged, and the peak number of threads while loading
+        std::vector<double> latencies;
+        size_t peakThreadCount = processThreadCount();
+
         // rendering main loop
-        while (viewer->advanceToNextFrame() && (numFrames < 0 || (numFrames--) > 0))
+        while (viewer->active() && (numFrames < 0 || (numFrames--) > 0))
         {
+            {
+                TRACE_ZONE_CATEGORY("advanceToNextFrame", "frame");
+                if (!viewer->advanceToNextFrame()) break;
+            }
+
             // std::cout<<"new Frame"<<std::endl;
             // pass any events into EventHandlers assigned to the Viewer
             viewer->handleEvents();
 
-            viewer->update();
+            {
+                TRACE_ZONE_CATEGORY("update", "frame");
+                viewer->update();
+            }
 
-            viewer->recordAndSubmit();
+            if (loadTime == 0.0)
+            {
+                auto frameTime = vsg::clock::now();
+                frameTimes.push_back(std::chrono::duration<double, std::chrono::milliseconds::period>(frameTime - previousFrameTime).count());
+                previousFrameTime = frameTime;
 
-            viewer->present();
+                size_t numLoaded = static_cast<size_t>(std::count_if(vsg_scene->children.begin(), vsg_scene->children.end(), [](auto& child) { return !child.template cast<vsg::Group>()->children.empty(); }));
+                double sinceStart = std::chrono::duration<double, std::chrono::milliseconds::period>(frameTime - startTime).count();
+                latencies.resize(numLoaded, sinceStart);
+                peakThreadCount = std::max(peakThreadCount, processThreadCount());
+
+                // all models are loaded once every transform has had its model merged
+                if (numLoaded == vsg_scene->children.size()) loadTime = sinceStart;
+            }
+
+            {
+                TRACE_ZONE_CATEGORY("recordAndSubmit", "frame");
+                viewer->recordAndSubmit();
+            }
+
+            {
+                TRACE_ZONE_CATEGORY("present", "frame");
+                viewer->present();
+            }
 
             // if (loadThreads->queue->empty()) break;
         }
+
+        if (traceFilename && TRACE_ENABLED)
+        {
+            if (TraceEvents::instance().write(traceFilename))
+                std::cout << "Trace written to " << traceFilename << ", view with chrome://tracing or https://ui.perfetto.dev" << std::endl;
+            else
+                std::cout << "Warning: unable to write trace to " << traceFilename << std::endl;
+        }
+
+        if (loadTime > 0.0) std::cout << "All " << numModels << " models loaded in " << loadTime << "ms" << std::endl;
+        if (!latencies.empty())
+        {
+            // models are merged in order of completion so latencies is already sorted
+            auto at = [&](size_t percent) { return latencies[std::min(latencies.size() - 1, (latencies.size() * percent) / 100)]; };
+            std::cout << "Load latency p50 = " << at(50) << "ms, p95 = " << at(95) << "ms, max = " << latencies.back() << "ms" << std::endl;
+        }
+        std::cout << "Load threads = " << numLoadThreads;
+        if (peakThreadCount > 0) std::cout << ", peak process threads while loading = " << peakThreadCount;
+        std::cout << std::endl;
+        if (!frameTimes.empty())
+        {
+            // count frames taking more than twice the median as spikes
+            auto sorted = frameTimes;
+            std::sort(sorted.begin(), sorted.end());
+            double median = sorted[sorted.size() / 2];
+            auto numSpikes = std::count_if(frameTimes.begin(), frameTimes.end(), [&](double frameTime) { return frameTime > 2.0 * median; });
+            std::cout << "Frames while loading = " << frameTimes.size() << ", median = " << median << "ms, max = " << sorted.back() << "ms, spikes over " << 2.0 * median << "ms = " << numSpikes << std::endl;
+        }
+        if (loadPipeline)
+        {
+            std::cout << "Load pipeline stages:" << std::endl;
+            loadPipeline->report(std::cout);
+            loadPipeline->stop();
+        }
+
+        // join the load threads before returning, releasing any loads and suspended coroutines still queued on them
+        if (loadThreads) loadThreads->stop();
+        if (compileThreads) compileThreads->stop();
+        if (singleFlightReader)
+        {
+            std::cout << "SingleFlightReader numReads = " << singleFlightReader->numReads << ", redundant reads avoided = " << singleFlightReader->numReadsAvoided << std::endl;
+        }
     }
     catch (const vsg::Exception& ve)
     {
@@ -9,6 +9,8 @@
 #include <iostream>
 #include <thread>
 
+#include "TraceEvents.h"
+
 struct Merge : public vsg::Inherit<vsg::Operation, Merge>
 {
     Merge(const vsg::observer_ptr<vsg::Viewer> in_viewer, const vsg::CompileResult& in_compileResult):
@@ -21,6 +23,8 @@ struct Merge : public vsg::Inherit<vsg::Operation, Merge>
 
     void run() override
     {
+        TRACE_ZONE_CATEGORY("Merge::run", "merge");
+
         std::cout<<"Merge::run() Add window"<<std::endl;
 
         vsg::ref_ptr<vsg::Viewer> ref_viewer = viewer;
@@ -55,11 +59,19 @@ struct LoadWindowOperation : public vsg::Inherit<vsg::Operation, LoadWindowOpera
 
     void run() override
     {
+        TRACE_ZONE_CATEGORY("LoadWindowOperation::run", "operation");
+
         vsg::ref_ptr<vsg::Viewer> ref_viewer = viewer;
         vsg::ref_ptr<vsg::Window> ref_window = window;
 
         // std::cout << "Loading " << filename << std::endl;
-        if (auto node = vsg::read_cast<vsg::Node>(filename, options))
+        vsg::ref_ptr<vsg::Node> node;
+        {
+            TRACE_ZONE_CATEGORY(filename.string(), "read");
+            node = vsg::read_cast<vsg::Node>(filename, options);
+        }
+
+        if (node)
         {
             // std::cout << "Loaded " << filename << std::endl;
             auto traits = vsg::WindowTraits::create();
@@ -113,6 +125,7 @@ struct LoadWindowOperation : public vsg::Inherit<vsg::Operation, LoadWindowOpera
             // need to add view to compileManager
             ref_viewer->compileManager->add(*second_window, view);
 
+            TRACE_ZONE_CATEGORY("compile", "compile");
             auto result = ref_viewer->compileManager->compile(commandGraph, [&view](vsg::Context& context)
             {
                 if (context.view == view.get())
@@ -163,6 +176,9 @@ int main(int argc, char** argv)
         arguments.read("--display", windowTraits->display);
         auto numFrames = arguments.value(-1, "-f");
         auto numThreads = arguments.value(16, "-n");
+        auto traceFilename = arguments.value(vsg::Path(), "--trace");
+        if (traceFilename && !TRACE_ENABLED) std::cout << "Warning: --trace requires building with VSGEXAMPLES_TRACE enabled." << std::endl;
+        TraceEvents::instance().enabled = traceFilename && TRACE_ENABLED;
 
         // provide setting of the resource hints on the command line
         vsg::ref_ptr<vsg::ResourceHints> resourceHints;
@@ -240,25 +256,54 @@ int main(int argc, char** argv)
         // create threads to load models and views in background
         auto loadThreads = vsg::OperationThreads::create(numThreads, viewer->status);
 
+        // name the tracks of the trace output
+        TraceEvents::instance().setThreadName(std::this_thread::get_id(), "main");
+        for (size_t i = 0; i < loadThreads->threads.size(); ++i)
+        {
+            TraceEvents::instance().setThreadName(loadThreads->threads[i].get_id(), vsg::make_string("load thread ", i));
+        }
+
         // assign the LoadViewOperation that will do the load in the background and once loaded and compiled merged then via Merge operation that is assigned to updateOperations and called from viewer.update()
         vsg::observer_ptr<vsg::Viewer> observer_viewer(viewer);
         loadThreads->add(LoadWindowOperation::create(observer_viewer, window, 50, 50, 512, 480, "models/teapot.vsgt", options));
 
         // rendering main loop
-        while (viewer->advanceToNextFrame() && (numFrames < 0 || (numFrames--) > 0))
+        while (viewer->active() && (numFrames < 0 || (numFrames--) > 0))
         {
+            {
+                TRACE_ZONE_CATEGORY("advanceToNextFrame", "frame");
+                if (!viewer->advanceToNextFrame()) break;
+            }
+
             // std::cout<<"new Frame"<<std::endl;
             // pass any events into EventHandlers assigned to the Viewer
             viewer->handleEvents();
 
-            viewer->update();
+            {
+                TRACE_ZONE_CATEGORY("update", "frame");
+                viewer->update();
+            }
 
-            viewer->recordAndSubmit();
+            {
+                TRACE_ZONE_CATEGORY("recordAndSubmit", "frame");
+                viewer->recordAndSubmit();
+            }
 
-            viewer->present();
+            {
+                TRACE_ZONE_CATEGORY("present", "frame");
+                viewer->present();
+            }
 
             // if (loadThreads->queue->empty()) break;
         }
+
+        if (traceFilename && TRACE_ENABLED)
+        {
+            if (TraceEvents::instance().write(traceFilename))
+                std::cout << "Trace written to " << traceFilename << ", view with chrome://tracing or https://ui.perfetto.dev" << std::endl;
+            else
+                std::cout << "Warning: unable to write trace to " << traceFilename << std::endl;
+        }
     }
     catch (const vsg::Exception& ve)
     {
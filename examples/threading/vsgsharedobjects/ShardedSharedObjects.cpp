@@ -0,0 +1,111 @@
+#include "ShardedSharedObjects.h"
+
+#include <algorithm>
+#include <typeindex>
+
+namespace
+{
+    // FNV-1a over a sample of around 64 evenly spaced bytes, so large images cost no more to hash than small ones
+    size_t hashSample(const uint8_t* ptr, size_t size)
+    {
+        uint64_t hash = 14695981039346656037ull;
+        auto combine = [&](uint8_t byte) {
+            hash ^= byte;
+            hash *= 1099511628211ull;
+        };
+
+        for (size_t i = 0; i < sizeof(size); ++i) combine(static_cast<uint8_t>(size >> (i * 8)));
+
+        size_t step = std::max(size_t(1), size / 64);
+        for (size_t i = 0; i < size; i += step) combine(ptr[i]);
+
+        return static_cast<size_t>(hash);
+    }
+
+    void hashCombine(size_t& hash, size_t value)
+    {
+        hash ^= value + 0x9e3779b97f4a7c15ull + (hash << 6) + (hash >> 2);
+    }
+
+    // hash of a subset of the values that compare() compares, so objects that compare as equal have equal hashes. The
+    // objects referenced by the descriptors are hashed by value as compare() compares them by value, not by pointer.
+    size_t valueHash(const vsg::Object* object)
+    {
+        size_t hash = 0;
+        if (!object) return hash;
+
+        if (auto data = dynamic_cast<const vsg::Data*>(object))
+        {
+            // Data::compare() compares the raw data so equal Data have equal contents and sizes
+            if (data->dataPointer()) hash = hashSample(static_cast<const uint8_t*>(data->dataPointer()), data->dataSize());
+        }
+        else if (auto sampler = dynamic_cast<const vsg::Sampler*>(object))
+        {
+            for (auto value : {int64_t(sampler->magFilter), int64_t(sampler->minFilter), int64_t(sampler->mipmapMode), int64_t(sampler->addressModeU),
+                               int64_t(sampler->addressModeV), int64_t(sampler->addressModeW), int64_t(sampler->anisotropyEnable), int64_t(sampler->compareEnable),
+                               int64_t(sampler->compareOp), int64_t(sampler->borderColor), int64_t(sampler->unnormalizedCoordinates)})
+            {
+                hashCombine(hash, static_cast<size_t>(value));
+            }
+        }
+        else if (auto descriptor = dynamic_cast<const vsg::Descriptor*>(object))
+        {
+            hashCombine(hash, descriptor->dstBinding);
+            hashCombine(hash, descriptor->dstArrayElement);
+            hashCombine(hash, static_cast<size_t>(descriptor->descriptorType));
+
+            if (auto descriptorImage = dynamic_cast<const vsg::DescriptorImage*>(object))
+            {
+                for (auto& imageInfo : descriptorImage->imageInfoList)
+                {
+                    if (!imageInfo) continue;
+                    hashCombine(hash, valueHash(imageInfo->sampler.get()));
+                    if (imageInfo->imageView && imageInfo->imageView->image) hashCombine(hash, valueHash(imageInfo->imageView->image->data.get()));
+                }
+            }
+            else if (auto descriptorBuffer = dynamic_cast<const vsg::DescriptorBuffer*>(object))
+            {
+                for (auto& bufferInfo : descriptorBuffer->bufferInfoList)
+                {
+                    if (bufferInfo) hashCombine(hash, valueHash(bufferInfo->data.get()));
+                }
+            }
+        }
+        return hash;
+    }
+} // namespace
+
+ShardedSharedObjects::ShardedSharedObjects(size_t numShards)
+{
+    for (size_t i = 0; i < std::max(size_t(1), numShards); ++i)
+    {
+        _shards.push_back(std::make_unique<Shard>());
+    }
+}
+
+size_t ShardedSharedObjects::shardIndex(const vsg::Object& object) const
+{
+    size_t hash = std::type_index(typeid(object)).hash_code();
+    hashCombine(hash, valueHash(&object));
+    return hash % _shards.size();
+}
+
+size_t ShardedSharedObjects::size() const
+{
+    size_t count = 0;
+    for (auto& shard : _shards)
+    {
+        std::shared_lock<std::shared_mutex> lock(shard->mutex);
+        count += shard->objects.size();
+    }
+    return count;
+}
+
+void ShardedSharedObjects::clear()
+{
+    for (auto& shard : _shards)
+    {
+        std::unique_lock<std::shared_mutex> lock(shard->mutex);
+        shard->objects.clear();
+    }
+}
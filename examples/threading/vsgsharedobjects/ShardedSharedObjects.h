@@ -0,0 +1,92 @@
+#pragma once
+
+#include <vsg/all.h>
+
+#include <atomic>
+#include <memory>
+#include <set>
+#include <shared_mutex>
+
+// ShardedSharedObjects provides the same share() interface as vsg::SharedObjects, but rather than one lock guarding all
+// the shared objects, objects are spread across shards each with their own reader/writer lock. Objects that are already
+// shared, the common case once loading is under way, are found under a shared lock so concurrent lookups don't block each other.
+//
+// Objects that compare as equal must land in the same shard, so the shard is chosen from the object type and a hash of the
+// values compare() compares: for vsg::Data its size and a sample of its contents, for Sampler its settings, and for
+// DescriptorImage and DescriptorBuffer the hashes of the samplers and data they reference. All other objects of one type go to the same shard.
+class ShardedSharedObjects : public vsg::Inherit<vsg::Object, ShardedSharedObjects>
+{
+public:
+    explicit ShardedSharedObjects(size_t numShards = 64);
+
+    // replace object with a previously shared object that compares as equal, or add object if there isn't one.
+    template<class T>
+    void share(vsg::ref_ptr<T>& object)
+    {
+        share(object, [](vsg::ref_ptr<T>&) {});
+    }
+
+    // as above, calling initialize(object) when object is added, before any other thread can see it.
+    template<class T, typename Func>
+    void share(vsg::ref_ptr<T>& object, Func initialize)
+    {
+        if (!object) return;
+
+        vsg::ref_ptr<vsg::Object> key(object);
+        auto& shard = *_shards[shardIndex(*object)];
+
+        numLookups.fetch_add(1, std::memory_order_relaxed);
+        {
+            std::shared_lock<std::shared_mutex> lock(shard.mutex, std::try_to_lock);
+            if (!lock.owns_lock())
+            {
+                numContended.fetch_add(1, std::memory_order_relaxed);
+                lock.lock();
+            }
+
+            if (auto itr = shard.objects.find(key); itr != shard.objects.end())
+            {
+                object = vsg::ref_ptr<T>(static_cast<T*>(itr->get()));
+                return;
+            }
+        }
+
+        std::unique_lock<std::shared_mutex> lock(shard.mutex, std::try_to_lock);
+        if (!lock.owns_lock())
+        {
+            numContended.fetch_add(1, std::memory_order_relaxed);
+            lock.lock();
+        }
+
+        // another thread may have added an equal object since the shared lock was released
+        auto [itr, inserted] = shard.objects.insert(key);
+        if (inserted)
+        {
+            numInserted.fetch_add(1, std::memory_order_relaxed);
+            initialize(object);
+        }
+        else
+        {
+            object = vsg::ref_ptr<T>(static_cast<T*>(itr->get()));
+        }
+    }
+
+    size_t size() const;
+    void clear();
+
+    // counters for comparing sharding configurations, numContended counts the lock acquisitions that had to wait.
+    std::atomic<uint64_t> numLookups{0};
+    std::atomic<uint64_t> numInserted{0};
+    std::atomic<uint64_t> numContended{0};
+
+protected:
+    struct Shard
+    {
+        mutable std::shared_mutex mutex;
+        std::set<vsg::ref_ptr<vsg::Object>, vsg::DereferenceLess> objects;
+    };
+
+    size_t shardIndex(const vsg::Object& object) const;
+
+    std::vector<std::unique_ptr<Shard>> _shards;
+};
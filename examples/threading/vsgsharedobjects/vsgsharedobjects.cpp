@@ -0,0 +1,165 @@
+#include <vsg/all.h>
+
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+#include <set>
+#include <thread>
+
+#include "ShardedSharedObjects.h"
+
+struct Settings
+{
+    size_t numModels = 500;
+    size_t meshesPerModel = 8;
+    size_t numVertices = 256;
+    size_t numTextures = 32;
+    size_t numMaterials = 32;
+    uint32_t textureSize = 64;
+};
+
+struct Results
+{
+    double totalTime = 0.0; // milliseconds
+    double shareTime = 0.0; // milliseconds summed over all threads
+    uint64_t numShareCalls = 0;
+    size_t numDistinctTextures = 0;
+    size_t numDistinctMaterials = 0;
+};
+
+// create the state for one model in the same way a loader such as vsgXchange::assimp does, with each model creating its own
+// copies of the textures and materials from a common pool, and sharing them so that all models end up using the same objects.
+template<class S>
+void loadModel(S& sharedObjects, size_t modelIndex, const Settings& settings, std::vector<vsg::ref_ptr<vsg::Object>>& textures, std::vector<vsg::ref_ptr<vsg::Object>>& materials, double& shareTime, uint64_t& numShareCalls)
+{
+    auto share = [&](auto& object) {
+        auto start = vsg::clock::now();
+        sharedObjects.share(object);
+        shareTime += std::chrono::duration<double, std::chrono::milliseconds::period>(vsg::clock::now() - start).count();
+        ++numShareCalls;
+    };
+
+    for (size_t m = 0; m < settings.meshesPerModel; ++m)
+    {
+        // geometry is unique to each model but still goes through share() as a loader doesn't know in advance
+        auto vertices = vsg::vec3Array::create(settings.numVertices);
+        for (size_t i = 0; i < vertices->size(); ++i)
+        {
+            vertices->at(i).set(static_cast<float>(modelIndex), static_cast<float>(m), static_cast<float>(i));
+        }
+        share(vertices);
+
+        size_t textureIndex = (modelIndex * 7 + m) % settings.numTextures;
+        auto image = vsg::ubvec4Array2D::create(settings.textureSize, settings.textureSize, vsg::Data::Properties{VK_FORMAT_R8G8B8A8_UNORM});
+        for (auto& texel : *image)
+        {
+            texel.set(static_cast<uint8_t>(textureIndex), static_cast<uint8_t>(textureIndex * 3), static_cast<uint8_t>(textureIndex * 5), 255);
+        }
+        share(image);
+
+        auto sampler = vsg::Sampler::create();
+        share(sampler);
+
+        auto descriptorImage = vsg::DescriptorImage::create(sampler, image, 0, 0);
+        share(descriptorImage);
+
+        size_t materialIndex = (modelIndex * 3 + m) % settings.numMaterials;
+        auto material = vsg::PhongMaterialValue::create();
+        material->value().diffuse.set(static_cast<float>(materialIndex) / static_cast<float>(settings.numMaterials), 0.5f, 0.5f, 1.0f);
+        share(material);
+
+        auto descriptorMaterial = vsg::DescriptorBuffer::create(material, 10);
+        share(descriptorMaterial);
+
+        textures.push_back(descriptorImage);
+        materials.push_back(descriptorMaterial);
+    }
+}
+
+template<class S>
+Results loadModels(S& sharedObjects, size_t numThreads, const Settings& settings)
+{
+    std::atomic<size_t> nextModel{0};
+    std::vector<std::vector<vsg::ref_ptr<vsg::Object>>> textures(numThreads), materials(numThreads);
+    std::vector<double> shareTimes(numThreads, 0.0);
+    std::vector<uint64_t> numShareCalls(numThreads, 0);
+
+    auto startLatch = vsg::Latch::create(1);
+
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < numThreads; ++t)
+    {
+        threads.emplace_back([&, t]() {
+            startLatch->wait();
+            for (size_t model = nextModel++; model < settings.numModels; model = nextModel++)
+            {
+                loadModel(sharedObjects, model, settings, textures[t], materials[t], shareTimes[t], numShareCalls[t]);
+            }
+        });
+    }
+
+    auto startTime = vsg::clock::now();
+    startLatch->count_down();
+    for (auto& thread : threads) thread.join();
+
+    Results results;
+    results.totalTime = std::chrono::duration<double, std::chrono::milliseconds::period>(vsg::clock::now() - startTime).count();
+
+    // check that the sharing worked, all models should be using one object per distinct texture and material
+    std::set<vsg::Object*> distinctTextures, distinctMaterials;
+    for (size_t t = 0; t < numThreads; ++t)
+    {
+        for (auto& texture : textures[t]) distinctTextures.insert(texture.get());
+        for (auto& material : materials[t]) distinctMaterials.insert(material.get());
+        results.shareTime += shareTimes[t];
+        results.numShareCalls += numShareCalls[t];
+    }
+    results.numDistinctTextures = distinctTextures.size();
+    results.numDistinctMaterials = distinctMaterials.size();
+
+    return results;
+}
+
+int main(int argc, char** argv)
+{
+    vsg::CommandLine arguments(&argc, argv);
+
+    Settings settings;
+    arguments.read("-m", settings.numModels);
+    arguments.read("--meshes", settings.meshesPerModel);
+    arguments.read("--textures", settings.numTextures);
+    arguments.read("--materials", settings.numMaterials);
+    arguments.read("--texture-size", settings.textureSize);
+    auto maxThreads = arguments.value<size_t>(32, "-t");
+    auto numShards = arguments.value<size_t>(64, "--shards");
+
+    if (arguments.errors()) return arguments.writeErrorMessages(std::cerr);
+
+    std::cout << settings.numModels << " models x " << settings.meshesPerModel << " meshes, sharing " << settings.numTextures << " textures and " << settings.numMaterials << " materials, " << numShards << " shards" << std::endl;
+    std::cout << std::fixed << std::setprecision(2);
+
+    auto report = [](const std::string& name, const Results& results, const ShardedSharedObjects* sharded) {
+        std::cout << "    " << std::left << std::setw(22) << name << std::right << " total = " << std::setw(9) << results.totalTime << "ms, in share() = " << std::setw(9) << results.shareTime
+                  << "ms, per call = " << std::setw(7) << (results.shareTime * 1.0e6 / static_cast<double>(std::max(uint64_t(1), results.numShareCalls))) << "ns"
+                  << ", distinct textures/materials = " << results.numDistinctTextures << "/" << results.numDistinctMaterials;
+        if (sharded) std::cout << ", contended = " << sharded->numContended << " of " << sharded->numLookups;
+        std::cout << std::endl;
+    };
+
+    for (size_t numThreads = 1; numThreads <= maxThreads; numThreads *= 2)
+    {
+        std::cout << "threads = " << numThreads << std::endl;
+
+        {
+            auto sharedObjects = vsg::SharedObjects::create();
+            report("vsg::SharedObjects", loadModels(*sharedObjects, numThreads, settings), nullptr);
+        }
+
+        {
+            auto sharedObjects = ShardedSharedObjects::create(numShards);
+            report("ShardedSharedObjects", loadModels(*sharedObjects, numThreads, settings), sharedObjects.get());
+        }
+    }
+
+    return 0;
+}
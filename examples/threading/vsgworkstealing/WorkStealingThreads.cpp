@@ -0,0 +1,196 @@
+#include "WorkStealingThreads.h"
+
+namespace
+{
+    // the scheduler and deque index of the calling thread when it's one of a WorkStealingThreads' threads.
+    struct CurrentWorker
+    {
+        const WorkStealingThreads* scheduler = nullptr;
+        size_t index = 0;
+    };
+
+    thread_local CurrentWorker s_currentWorker;
+} // namespace
+
+WorkStealingThreads::WorkStealingThreads(uint32_t numThreads, vsg::ref_ptr<vsg::ActivityStatus> in_status) :
+    status(in_status)
+{
+    if (!status) status = vsg::ActivityStatus::create();
+    if (numThreads == 0) numThreads = 1;
+
+    // all the deques must exist before any thread starts stealing from them
+    for (uint32_t i = 0; i < numThreads; ++i)
+    {
+        _workers.push_back(std::make_unique<Worker>());
+    }
+
+    for (uint32_t i = 0; i < numThreads; ++i)
+    {
+        threads.emplace_back([this, i]() { workerLoop(i); });
+    }
+}
+
+WorkStealingThreads::~WorkStealingThreads()
+{
+    stop();
+}
+
+void WorkStealingThreads::add(vsg::ref_ptr<vsg::Operation> operation, Priority priority, vsg::ref_ptr<CancellationToken> token)
+{
+    if (!operation) return;
+
+    // operations added by one of our own threads stay on its deque, others are spread across the threads
+    size_t index = (s_currentWorker.scheduler == this) ? s_currentWorker.index : (_nextWorker.fetch_add(1, std::memory_order_relaxed) % _workers.size());
+
+    // count the task before it's visible to the other threads so a thief taking it can't decrement _numQueued below zero
+    _numOutstanding.fetch_add(1);
+    _numQueued.fetch_add(1);
+
+    auto& worker = *_workers[index];
+    {
+        std::scoped_lock<std::mutex> lock(worker.mutex);
+        worker.queues[priority].push_back(Task{operation, token});
+    }
+
+    // only wake a thread if one is waiting, taking the lock so a thread that has just found nothing to do can't miss
+    // the notification before it waits
+    if (_numWaiting.load() > 0)
+    {
+        std::scoped_lock<std::mutex> lock(_mutex);
+        _workAvailable.notify_one();
+    }
+}
+
+bool WorkStealingThreads::take(size_t index, Task& task)
+{
+    size_t numWorkers = _workers.size();
+    for (int priority = 0; priority < NUM_PRIORITIES; ++priority)
+    {
+        // newest first from our own deque
+        if (index < numWorkers)
+        {
+            auto& worker = *_workers[index];
+            std::scoped_lock<std::mutex> lock(worker.mutex);
+            auto& queue = worker.queues[priority];
+            if (!queue.empty())
+            {
+                task = std::move(queue.back());
+                queue.pop_back();
+                _numQueued.fetch_sub(1);
+                return true;
+            }
+        }
+
+        // oldest first from the other threads' deques
+        for (size_t i = 1; i <= numWorkers; ++i)
+        {
+            size_t victim = (index + i) % numWorkers;
+            if (victim == index) continue;
+
+            auto& worker = *_workers[victim];
+            std::scoped_lock<std::mutex> lock(worker.mutex);
+            auto& queue = worker.queues[priority];
+            if (!queue.empty())
+            {
+                task = std::move(queue.front());
+                queue.pop_front();
+                _numQueued.fetch_sub(1);
+                _numStolen.fetch_add(1, std::memory_order_relaxed);
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+void WorkStealingThreads::runTask(Task& task)
+{
+    if (task.token && task.token->cancelled())
+    {
+        _numDiscarded.fetch_add(1, std::memory_order_relaxed);
+    }
+    else
+    {
+        task.operation->run();
+        _numRun.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    task = {};
+
+    if (_numOutstanding.fetch_sub(1) == 1)
+    {
+        std::scoped_lock<std::mutex> lock(_mutex);
+        _idle.notify_all();
+    }
+}
+
+void WorkStealingThreads::workerLoop(size_t index)
+{
+    s_currentWorker = CurrentWorker{this, index};
+
+    Task task;
+    while (status->active())
+    {
+        if (take(index, task))
+        {
+            runTask(task);
+            continue;
+        }
+
+        // the status may be shared with the viewer and set inactive without a notification so don't wait indefinitely
+        std::unique_lock<std::mutex> lock(_mutex);
+        ++_numWaiting;
+        _workAvailable.wait_for(lock, std::chrono::milliseconds(100), [&]() { return _numQueued.load() > 0 || !status->active(); });
+        --_numWaiting;
+    }
+
+    s_currentWorker = {};
+}
+
+void WorkStealingThreads::run()
+{
+    size_t index = (s_currentWorker.scheduler == this) ? s_currentWorker.index : _workers.size();
+
+    Task task;
+    while (take(index, task))
+    {
+        runTask(task);
+    }
+}
+
+void WorkStealingThreads::wait()
+{
+    std::unique_lock<std::mutex> lock(_mutex);
+    _idle.wait(lock, [&]() { return _numOutstanding.load() == 0; });
+}
+
+void WorkStealingThreads::stop()
+{
+    status->set(false);
+    {
+        std::scoped_lock<std::mutex> lock(_mutex);
+        _workAvailable.notify_all();
+    }
+
+    for (auto& thread : threads)
+    {
+        if (thread.joinable()) thread.join();
+    }
+    threads.clear();
+
+    // discard whatever is left so wait() doesn't block
+    for (auto& worker : _workers)
+    {
+        std::scoped_lock<std::mutex> lock(worker->mutex);
+        for (auto& queue : worker->queues)
+        {
+            _numQueued.fetch_sub(queue.size());
+            _numDiscarded.fetch_add(queue.size());
+            _numOutstanding.fetch_sub(queue.size());
+            queue.clear();
+        }
+    }
+
+    std::scoped_lock<std::mutex> lock(_mutex);
+    _idle.notify_all();
+}
@@ -0,0 +1,98 @@
+#pragma once
+
+#include <vsg/all.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+// CancellationToken is shared by operations that should be abandoned together, such as all the loads for a tile that has
+// gone out of view. Queued operations whose token has been cancelled are discarded without being run, while running
+// operations that hold on to the token can poll cancelled() and return early.
+class CancellationToken : public vsg::Inherit<vsg::Object, CancellationToken>
+{
+public:
+    void cancel() { _cancelled.store(true, std::memory_order_relaxed); }
+    bool cancelled() const { return _cancelled.load(std::memory_order_relaxed); }
+
+protected:
+    std::atomic_bool _cancelled{false};
+};
+
+// WorkStealingThreads is an alternative to vsg::OperationThreads in which each thread has its own deque for each priority
+// class rather than all threads sharing a single FIFO queue. Operations added from one of the threads go on that thread's
+// deques and are taken newest first, keeping related work on the same thread, while idle threads steal the oldest
+// operations from the other threads' deques. Higher priority operations are always taken before lower priority ones,
+// whichever thread they were queued on.
+class WorkStealingThreads : public vsg::Inherit<vsg::Object, WorkStealingThreads>
+{
+public:
+    enum Priority
+    {
+        HIGH = 0, // i.e. tiles that are visible now
+        NORMAL,
+        LOW, // i.e. prefetching of tiles that may be needed later
+        NUM_PRIORITIES
+    };
+
+    explicit WorkStealingThreads(uint32_t numThreads, vsg::ref_ptr<vsg::ActivityStatus> in_status = {});
+    WorkStealingThreads(const WorkStealingThreads&) = delete;
+    ~WorkStealingThreads();
+
+    vsg::ref_ptr<vsg::ActivityStatus> status;
+    std::vector<std::thread> threads;
+
+    void add(vsg::ref_ptr<vsg::Operation> operation, Priority priority = NORMAL, vsg::ref_ptr<CancellationToken> token = {});
+
+    // run queued operations on the calling thread until there are none left to take.
+    void run();
+
+    // block until all the operations added so far have been run or discarded.
+    void wait();
+
+    // stop the threads, discarding any operations still queued.
+    void stop();
+
+    struct Stats
+    {
+        uint64_t numRun = 0;
+        uint64_t numStolen = 0;
+        uint64_t numDiscarded = 0;
+    };
+
+    Stats stats() const { return Stats{_numRun.load(), _numStolen.load(), _numDiscarded.load()}; }
+
+protected:
+    struct Task
+    {
+        vsg::ref_ptr<vsg::Operation> operation;
+        vsg::ref_ptr<CancellationToken> token;
+    };
+
+    struct Worker
+    {
+        std::mutex mutex;
+        std::deque<Task> queues[NUM_PRIORITIES];
+    };
+
+    bool take(size_t index, Task& task);
+    void runTask(Task& task);
+    void workerLoop(size_t index);
+
+    std::vector<std::unique_ptr<Worker>> _workers;
+    std::atomic<size_t> _nextWorker{0};
+
+    std::atomic<size_t> _numQueued{0};
+    std::atomic<size_t> _numOutstanding{0};
+    std::atomic<size_t> _numWaiting{0};
+    std::mutex _mutex;
+    std::condition_variable _workAvailable;
+    std::condition_variable _idle;
+
+    std::atomic<uint64_t> _numRun{0};
+    std::atomic<uint64_t> _numStolen{0};
+    std::atomic<uint64_t> _numDiscarded{0};
+};
@@ -0,0 +1,236 @@
+#include <vsg/all.h>
+
+#include <algorithm>
+#include <functional>
+#include <iostream>
+#include <limits>
+
+#include "WorkStealingThreads.h"
+
+// BusyOperation keeps its thread busy for a fixed duration, standing in for short tasks such as merging a tile and long
+// tasks such as reading and building a model, and records the time from being added to completing.
+struct BusyOperation : public vsg::Inherit<vsg::Operation, BusyOperation>
+{
+    BusyOperation(std::chrono::microseconds in_duration, double* in_latency, vsg::ref_ptr<CancellationToken> in_token = {}) :
+        duration(in_duration),
+        latency(in_latency),
+        token(in_token),
+        addTime(vsg::clock::now()) {}
+
+    std::chrono::microseconds duration;
+    double* latency = nullptr;
+    vsg::ref_ptr<CancellationToken> token;
+    vsg::time_point addTime;
+
+    // called once the work is done, used by the nested benchmark to add follow on operations
+    std::function<void()> completed;
+
+    vsg::ref_ptr<vsg::Latch> latch;
+
+    void run() override
+    {
+        auto endTime = vsg::clock::now() + duration;
+        while (vsg::clock::now() < endTime)
+        {
+            // cooperative cancellation, a real operation would check between stages of its work
+            if (token && token->cancelled()) break;
+        }
+
+        if (completed) completed();
+
+        *latency = std::chrono::duration<double, std::chrono::milliseconds::period>(vsg::clock::now() - addTime).count();
+        if (latch) latch->count_down();
+    }
+};
+
+struct Settings
+{
+    uint32_t numThreads = 8;
+    size_t numShort = 20000;
+    size_t numLong = 200;
+    std::chrono::microseconds shortDuration{20};
+    std::chrono::microseconds longDuration{5000};
+    size_t numChildren = 50;
+    double cancelRatio = 0.5;
+};
+
+struct Results
+{
+    std::vector<double> shortLatencies;
+    std::vector<double> longLatencies;
+    double totalTime = 0.0;
+    WorkStealingThreads::Stats stats;
+};
+
+// common interface over the two schedulers, with vsg::OperationThreads ignoring the priority
+struct Scheduler
+{
+    std::function<void(vsg::ref_ptr<vsg::Operation>, WorkStealingThreads::Priority)> add;
+    std::function<void()> wait;
+    std::function<WorkStealingThreads::Stats()> stats;
+};
+
+void report(const std::string& name, const Results& results, size_t numTasks)
+{
+    auto percentiles = [](std::vector<double> latencies) {
+        // cancelled operations that were discarded before running have no latency
+        latencies.erase(std::remove_if(latencies.begin(), latencies.end(), [](double latency) { return latency < 0.0; }), latencies.end());
+        if (latencies.empty()) return std::string("none run");
+
+        std::sort(latencies.begin(), latencies.end());
+        auto at = [&](size_t percent) { return latencies[std::min(latencies.size() - 1, (latencies.size() * percent) / 100)]; };
+        return vsg::make_string("p50 = ", at(50), "ms, p99 = ", at(99), "ms, max = ", latencies.back(), "ms");
+    };
+
+    std::cout << "    " << name << " : " << results.totalTime << "ms, " << (static_cast<double>(numTasks) / results.totalTime * 1000.0) << " tasks/sec" << std::endl;
+    std::cout << "        short latency " << percentiles(results.shortLatencies) << std::endl;
+    std::cout << "        long latency  " << percentiles(results.longLatencies) << std::endl;
+    if (results.stats.numRun > 0) std::cout << "        run = " << results.stats.numRun << ", stolen = " << results.stats.numStolen << ", discarded = " << results.stats.numDiscarded << std::endl;
+}
+
+// short and long operations added together from the main thread, with one long operation after every numShort/numLong short ones.
+Results mixed(Scheduler& scheduler, const Settings& settings, bool cancel)
+{
+    Results results;
+    results.shortLatencies.resize(settings.numShort, -1.0);
+    results.longLatencies.resize(settings.numLong, -1.0);
+
+    std::vector<vsg::ref_ptr<CancellationToken>> tokens;
+    for (size_t i = 0; i < settings.numLong; ++i) tokens.push_back(CancellationToken::create());
+
+    auto startTime = vsg::clock::now();
+
+    size_t shortPerLong = settings.numLong > 0 ? std::max(size_t(1), settings.numShort / settings.numLong) : std::numeric_limits<size_t>::max();
+    size_t s = 0, l = 0;
+    while (s < settings.numShort || l < settings.numLong)
+    {
+        if (l < settings.numLong && (s >= settings.numShort || s % shortPerLong == 0))
+        {
+            scheduler.add(BusyOperation::create(settings.longDuration, &results.longLatencies[l], tokens[l]), WorkStealingThreads::LOW);
+            ++l;
+        }
+        if (s < settings.numShort)
+        {
+            scheduler.add(BusyOperation::create(settings.shortDuration, &results.shortLatencies[s]), WorkStealingThreads::HIGH);
+            ++s;
+        }
+    }
+
+    if (cancel)
+    {
+        // the viewer has moved on, so a proportion of the long operations, queued or running, are no longer needed
+        size_t numCancelled = static_cast<size_t>(static_cast<double>(settings.numLong) * settings.cancelRatio);
+        for (size_t i = 0; i < numCancelled; ++i) tokens[(i * settings.numLong) / std::max(numCancelled, size_t(1))]->cancel();
+    }
+
+    scheduler.wait();
+
+    results.totalTime = std::chrono::duration<double, std::chrono::milliseconds::period>(vsg::clock::now() - startTime).count();
+    results.stats = scheduler.stats();
+    return results;
+}
+
+// long operations that each add numChildren short operations once done, as a load adds its compile and merge work.
+Results nested(Scheduler& scheduler, const Settings& settings)
+{
+    Results results;
+    results.shortLatencies.resize(settings.numLong * settings.numChildren, -1.0);
+    results.longLatencies.resize(settings.numLong, -1.0);
+
+    auto startTime = vsg::clock::now();
+
+    for (size_t l = 0; l < settings.numLong; ++l)
+    {
+        auto parent = BusyOperation::create(settings.longDuration, &results.longLatencies[l]);
+        parent->completed = [&scheduler, &settings, &results, l]() {
+            for (size_t c = 0; c < settings.numChildren; ++c)
+            {
+                scheduler.add(BusyOperation::create(settings.shortDuration, &results.shortLatencies[l * settings.numChildren + c]), WorkStealingThreads::HIGH);
+            }
+        };
+        scheduler.add(parent, WorkStealingThreads::NORMAL);
+    }
+
+    scheduler.wait();
+
+    results.totalTime = std::chrono::duration<double, std::chrono::milliseconds::period>(vsg::clock::now() - startTime).count();
+    results.stats = scheduler.stats();
+    return results;
+}
+
+// vsg::OperationThreads has no way to wait for its queue to empty so count the operations down on a latch instead.
+Scheduler createOperationThreadsScheduler(vsg::ref_ptr<vsg::OperationThreads> operationThreads, size_t numTasks)
+{
+    auto latch = vsg::Latch::create(static_cast<int>(numTasks));
+
+    Scheduler scheduler;
+    scheduler.add = [operationThreads, latch](vsg::ref_ptr<vsg::Operation> operation, WorkStealingThreads::Priority) {
+        if (auto busy = operation.cast<BusyOperation>()) busy->latch = latch;
+        operationThreads->add(operation);
+    };
+    scheduler.wait = [latch]() { latch->wait(); };
+    scheduler.stats = []() { return WorkStealingThreads::Stats{}; };
+    return scheduler;
+}
+
+Scheduler createWorkStealingScheduler(vsg::ref_ptr<WorkStealingThreads> workStealingThreads)
+{
+    Scheduler scheduler;
+    scheduler.add = [workStealingThreads](vsg::ref_ptr<vsg::Operation> operation, WorkStealingThreads::Priority priority) {
+        auto busy = operation.cast<BusyOperation>();
+        workStealingThreads->add(operation, priority, busy ? busy->token : vsg::ref_ptr<CancellationToken>());
+    };
+    scheduler.wait = [workStealingThreads]() { workStealingThreads->wait(); };
+    scheduler.stats = [workStealingThreads]() { return workStealingThreads->stats(); };
+    return scheduler;
+}
+
+int main(int argc, char** argv)
+{
+    vsg::CommandLine arguments(&argc, argv);
+
+    Settings settings;
+    settings.numThreads = arguments.value(std::max(2u, std::thread::hardware_concurrency()), "-n");
+    arguments.read("--short", settings.numShort);
+    arguments.read("--long", settings.numLong);
+    settings.shortDuration = std::chrono::microseconds(arguments.value(20, "--short-us"));
+    settings.longDuration = std::chrono::microseconds(arguments.value(5000, "--long-us"));
+    arguments.read("--children", settings.numChildren);
+    arguments.read("--cancel", settings.cancelRatio);
+    auto numRepeats = arguments.value(1, "-r");
+
+    if (arguments.errors()) return arguments.writeErrorMessages(std::cerr);
+
+    std::cout << "threads = " << settings.numThreads << ", short = " << settings.numShort << " x " << settings.shortDuration.count() << "us, long = " << settings.numLong << " x " << settings.longDuration.count() << "us" << std::endl;
+
+    size_t numMixed = settings.numShort + settings.numLong;
+    size_t numNested = settings.numLong * (1 + settings.numChildren);
+
+    for (int repeat = 0; repeat < numRepeats; ++repeat)
+    {
+        // new threads for each run so the counters and stats start from zero
+        auto run = [&](const std::string& name, size_t numTasks, std::function<Results(Scheduler&)> benchmark) {
+            {
+                auto operationThreads = vsg::OperationThreads::create(settings.numThreads);
+                auto scheduler = createOperationThreadsScheduler(operationThreads, numTasks);
+                report(name + " OperationThreads", benchmark(scheduler), numTasks);
+            }
+            {
+                auto workStealingThreads = WorkStealingThreads::create(settings.numThreads);
+                auto scheduler = createWorkStealingScheduler(workStealingThreads);
+                report(name + " WorkStealingThreads", benchmark(scheduler), numTasks);
+            }
+        };
+
+        std::cout << "\nmixed short and long operations" << std::endl;
+        run("mixed", numMixed, [&](Scheduler& scheduler) { return mixed(scheduler, settings, false); });
+
+        std::cout << "\nmixed with " << settings.cancelRatio * 100.0 << "% of long operations cancelled" << std::endl;
+        run("cancel", numMixed, [&](Scheduler& scheduler) { return mixed(scheduler, settings, true); });
+
+        std::cout << "\nlong operations adding " << settings.numChildren << " short operations each" << std::endl;
+        run("nested", numNested, [&](Scheduler& scheduler) { return nested(scheduler, settings); });
+    }
+
+    return 0;
+}